@@ -0,0 +1,47 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _CYCLE_TIMER_H_
+#define _CYCLE_TIMER_H_
+
+#include "gba_def.h"
+#include "gba_mmap.h"
+#include "gba_types.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * 32-bit CPU cycle counter built from timers 2 and 3: timer 2 ticks every
+ * cycle and timer 3 cascades off its overflow. Wraps after ~256 seconds.
+ * */
+#define CYCLE_TIMER_LO 2
+#define CYCLE_TIMER_HI 3
+
+#define TM_CNT_CASCADE 0x0004
+#define TM_CNT_ENABLE  0x0080
+
+static inline void Cycle_Timer_Start(void) {
+  *REG_TIMER_CNT(CYCLE_TIMER_LO) = 0;
+  *REG_TIMER_CNT(CYCLE_TIMER_HI) = 0;
+  *REG_TIMER_DATA(CYCLE_TIMER_LO) = 0;
+  *REG_TIMER_DATA(CYCLE_TIMER_HI) = 0;
+  *REG_TIMER_CNT(CYCLE_TIMER_HI) = TM_CNT_ENABLE|TM_CNT_CASCADE;
+  *REG_TIMER_CNT(CYCLE_TIMER_LO) = TM_CNT_ENABLE|TM_FREQ_1HZ;
+}
+
+static inline u32 Cycle_Timer_Read(void) {
+  u32 hi, lo;
+  do {
+    hi = *REG_TIMER_DATA(CYCLE_TIMER_HI);
+    lo = *REG_TIMER_DATA(CYCLE_TIMER_LO);
+  } while (hi != *REG_TIMER_DATA(CYCLE_TIMER_HI));
+  return (hi<<16)|lo;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _CYCLE_TIMER_H_ */
@@ -0,0 +1,70 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _DIRTY_CELLS_H_
+#define _DIRTY_CELLS_H_
+
+#include "gba_types.h"
+#include "maze.h"
+#include "maze_render.h"
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+/*
+ * Deferred cell redraws. Algorithms mark cells instead of drawing them; a
+ * pending bitset merges repeat marks of the same cell (the last color marked
+ * wins, and the cell is drawn from its state at flush time), and a FIFO of
+ * cell indices keeps flush order. Dirty_Cells_Flush then draws queued cells
+ * only while the display is in VBlank, so algorithm throughput no longer
+ * depends on how often cells get redrawn, and nothing tears.
+ * Until Dirty_Cells_Init is called for a maze, marking that maze just draws
+ * the cell on the spot, as draw_maze_cell would.
+ * */
+
+// Or into a mark's color to fill the whole cell with it, walls and all, e.g.
+// for cells that are on a walk but not in the maze yet
+#define DIRTY_CELL_FILL RENDER_CELL_FILL
+
+#ifndef DIRTY_QUEUE_CAP
+// Marks past this many pending cells get drawn immediately instead. Enough
+// for every cell of the largest size preset (120x80), which matters for the
+// engines that generate a whole maze in one scheduler step.
+#define DIRTY_QUEUE_CAP 10240
+#endif
+
+#ifndef DIRTY_RAW_COLOR_CT
+// Distinct plain (not RENDER_STATE) colors marks can use between Inits. Every
+// render state has a slot of its own on top of these. Running out is a bug:
+// it asserts, since the only fallback is drawing outside VBlank.
+#define DIRTY_RAW_COLOR_CT 16
+#endif
+#define DIRTY_COLOR_CT (RENDER_STATE_CT + DIRTY_RAW_COLOR_CT)
+
+#ifndef DIRTY_FLUSH_VCOUNT_END
+// VBlank is scanlines 160-227; stop flushing a line before it ends
+#define DIRTY_FLUSH_VCOUNT_END 226
+#endif
+
+typedef struct s_dirty_cells_stats {
+  u32 marked, merged, drawn, overflowed;
+} DirtyCellsStats_t;
+
+extern DirtyCellsStats_t DIRTY_CELLS_STATS;
+
+bool Dirty_Cells_Init(const Maze_t *maze);
+void Dirty_Cells_Close(void);
+void Dirty_Cells_Mark(const Maze_t *maze, const Coord_t *coord, u32 color);
+u32 Dirty_Cells_Pending(void);
+u32 Dirty_Cells_Flush(u32 vcount_end);
+void Dirty_Cells_Flush_All(void);
+void Dirty_Cells_Drain(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _DIRTY_CELLS_H_ */
@@ -0,0 +1,91 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _EVENT_LOG_H_
+#define _EVENT_LOG_H_
+
+#include "gba_types.h"
+#include "maze_observer.h"
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+/*
+ * Recorded algorithm progress, played back at its own pace. With
+ * EVENT_LOG_OBSERVER as a maze's observer, generators, graphing and the
+ * solver push a compact event per thing worth showing into a ring buffer and
+ * carry on at full speed; the player hands events to a play callback (which
+ * does the actual drawing) at a set number of events a second, ticked once a
+ * frame. Fast-forward multiplies the rate, and skip plays everything pending
+ * at once.
+ * A push into a full ring plays the oldest event on the spot to make room, so
+ * nothing is ever dropped, but that happens inside an algorithm step, in the
+ * middle of a frame. Those events reach the play callback with overflow set,
+ * and it must only apply their state (queue the cell's redraw, move sprites
+ * in shadow OAM): no scrolling the view, no writing VRAM. The redraws land in
+ * VBlank with everything else.
+ * Until Event_Log_Init is called, pushed events go nowhere.
+ * */
+
+#ifndef EVENT_LOG_CAP
+#define EVENT_LOG_CAP 8192
+#endif
+
+#ifndef EVENT_FF_SHIFT
+// Fast-forward plays 2^EVENT_FF_SHIFT times as fast
+#define EVENT_FF_SHIFT 3
+#endif
+
+// Player ticks a second, i.e. frames
+#define EVENT_TICK_RATE 60
+
+typedef enum e_maze_event_type {
+  // Cell joined the maze
+  ME_CARVE=0,
+  // Generator's walk stepped on the cell; arg is a MazeWalkMark_e
+  ME_WALK,
+  // Cell became a graph vertex
+  ME_VERTEX,
+  // Cell lies on a graph edge
+  ME_EDGE,
+  // Solver settled the cell's vertex
+  ME_VISIT,
+  // Solver lowered the distance to the cell's vertex
+  ME_RELAX,
+  // Cell's vertex is on the way back from the destination
+  ME_TRACE,
+  // Cell is on the solution path, arg'th from the start (mod 256)
+  ME_PATH,
+  ME_MAX
+} MazeEventType_e;
+
+typedef struct s_maze_event {
+  u8 type, x, y, arg;
+} MazeEvent_t;
+
+typedef void (*Event_Play_cb)(const MazeEvent_t *event, bool overflow, void *userdata);
+
+typedef struct s_event_log_stats {
+  u32 pushed, played, overflowed;
+} EventLogStats_t;
+
+extern EventLogStats_t EVENT_LOG_STATS;
+extern const MazeObserver_t EVENT_LOG_OBSERVER;
+
+bool Event_Log_Init(Event_Play_cb play_cb, void *userdata);
+void Event_Log_Close(void);
+void Event_Log_Push(MazeEventType_e type, Coord_t cell, u8 arg);
+u32 Event_Log_Pending(void);
+void Event_Player_Set_Rate(u32 events_per_sec);
+void Event_Player_Fast_Forward(bool on);
+void Event_Player_Skip(void);
+u32 Event_Player_Tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _EVENT_LOG_H_ */
@@ -0,0 +1,83 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _GBA_DMA_H_
+#define _GBA_DMA_H_
+
+#include "gba_mmap.h"
+#include "gba_types.h"
+#include "gba_util_macros.h"
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+/*
+ * DMA3 copies and fills. Fills use fixed-source mode: the source is a single
+ * value in memory that every unit of the transfer reads again, so a span of
+ * any length costs the CPU three register writes. DMA3 runs immediately and
+ * halts the CPU until done, so nothing here ever has to wait on it.
+ * Fills can also be queued with DMA_Fill_Push and run back-to-back by
+ * DMA_Fill_Submit, e.g. every row of a rect, or every floor span of a frame.
+ * */
+
+// DMA CNT control bits (upper half of REG_DMA_CNT)
+#define DMA_DST_INC     0
+#define DMA_DST_DEC     (1UL<<21)
+#define DMA_DST_FIXED   (2UL<<21)
+#define DMA_SRC_INC     0
+#define DMA_SRC_DEC     (1UL<<23)
+#define DMA_SRC_FIXED   (2UL<<23)
+#define DMA_16          0
+#define DMA_32          (1UL<<26)
+#define DMA_NOW         0
+#define DMA_ENABLE      (1UL<<31)
+
+#ifndef DMA_FILL_QUEUE_CT
+#define DMA_FILL_QUEUE_CT 64
+#endif
+
+// Spans shorter than this many pixels are cheaper to fill with the CPU than
+// to set DMA up for
+#ifndef DMA_FILL_MIN_SPAN
+#define DMA_FILL_MIN_SPAN 16
+#endif
+
+typedef struct s_dma_fill {
+  void *dst;
+  // Fixed source of the transfer, so it must stay put until it has run
+  u32 value;
+  u32 cnt;
+} DmaFill_t;
+
+STAT_INLN void DMA3_Transfer(void *dst, const void *src, u32 count, u32 mode) {
+  REG_DMA_CNT(3) = 0;
+  REG_DMA_SRC(3) = src;
+  REG_DMA_DST(3) = dst;
+  REG_DMA_CNT(3) = count | mode | DMA_ENABLE;
+}
+
+STAT_INLN void DMA3_Copy32(void *dst, const void *src, u32 word_ct) {
+  DMA3_Transfer(dst, src, word_ct, DMA_32|DMA_SRC_INC|DMA_DST_INC|DMA_NOW);
+}
+
+STAT_INLN void DMA3_Copy16(void *dst, const void *src, u32 hword_ct) {
+  DMA3_Transfer(dst, src, hword_ct, DMA_16|DMA_SRC_INC|DMA_DST_INC|DMA_NOW);
+}
+
+void DMA3_Fill16(void *dst, u16 value, u32 hword_ct);
+void DMA3_Fill32(void *dst, u32 value, u32 word_ct);
+
+void DMA_Fill_Push(void *dst, u32 value, u32 count, bool words);
+u32 DMA_Fill_Pending(void);
+void DMA_Fill_Submit(void);
+void DMA_Fill_Span16(u16 *dst, u16 value, u32 hword_ct);
+void DMA_Fill_Rect16(u16 *fb, int stride, const BMP_Rect_t *rect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _GBA_DMA_H_ */
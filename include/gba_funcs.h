@@ -6,6 +6,7 @@
 #define _GBA_FUNCS_H_
 
 #include "gba_def.h"
+#include "gba_dma.h"
 #include "gba_mmap.h"
 #include "gba_types.h"
 #include "gba_util_macros.h"
@@ -26,7 +27,7 @@ IWRAM_CODE void ISR_MAIN_HANDLER(void);
 
 IWRAM_CODE void fast_memset32(void *dst, u32 val, size_t word_ct);
 IWRAM_CODE void fast_memcpy32(void *dst, const void *src, size_t word_ct);
-#define MODE3_CLEAR_SCREEN() fast_memset32(VRAM_BUF, 0, SCREEN_WIDTH*SCREEN_HEIGHT/2)
+#define MODE3_CLEAR_SCREEN() DMA3_Fill32(VRAM_BUF, 0, SCREEN_WIDTH*SCREEN_HEIGHT/2)
 
 bool SRAM_Read(void *dest, size_t len, size_t ofs);
 bool SRAM_Write(const void *data, size_t len, size_t ofs);
@@ -50,7 +51,7 @@ void SIO_Set_Multi(u16 baud);
 
 
 static inline void mode3_clear_screen(void) {
-  fast_memset32(VRAM_BUF, 0, (SCREEN_WIDTH*SCREEN_HEIGHT)>>1);
+  DMA3_Fill32(VRAM_BUF, 0, (SCREEN_WIDTH*SCREEN_HEIGHT)>>1);
 }
 
 
@@ -20,6 +20,10 @@ extern "C" {
 #define REG_DISPLAY_STAT (*((volatile u16*) (REG_BASE+0x0004)))
 #define REG_DISPLAY_VCOUNT (*((volatile u16*) (REG_BASE+0x0006)))
 
+#define REG_BG_CNT(bg_no) (*((volatile u16*) (REG_BASE + ((bg_no&3)<<1) + 0x0008)))
+#define REG_BG_HOFS(bg_no) (*((volatile u16*) (REG_BASE + ((bg_no&3)<<2) + 0x0010)))
+#define REG_BG_VOFS(bg_no) (*((volatile u16*) (REG_BASE + ((bg_no&3)<<2) + 0x0012)))
+
 #define REG_SIO_CNT (*((volatile u16*) (REG_BASE+0x0128)))
 #define REG_SIO_MULTI_SEND (*((volatile u16*) (REG_BASE+0x012A)))
 #define REG_SIO_RCNT (*((volatile u16*) (REG_BASE+0x0134)))
@@ -36,9 +40,12 @@ extern "C" {
 #define REG_KEY_CNT (*((volatile u16*) (REG_BASE+0x0132)))
 
 #define VRAM_BUF ((u16*) MEM_VRAM)
+#define MODE4_PAGE_SIZE 0xA000
+#define VRAM_PAGE(page_no) ((u16*) (MEM_VRAM + ((page_no)&1)*MODE4_PAGE_SIZE))
 
 #define TILE_MEM ((Charblock*) MEM_VRAM)
 #define TILE8_MEM ((Charblock8*) MEM_VRAM)
+#define SE_MEM ((Screenblock*) MEM_VRAM)
 
 #define PAL_BG_MEM ((u16*) MEM_PAL)
 #define PAL_OBJ_MEM ((u16*) (MEM_PAL + 0x0200))
@@ -53,6 +60,10 @@ extern "C" {
 #define REG_TIMER_CNT(timer_no) (((volatile u16*) (REG_BASE+ ((timer_no&3)<<2) + 0x102)))
 #define REG_TIMER_DATA(timer_no) (((volatile u16*) (REG_BASE+ ((timer_no&3)<<2) + 0x100)))
 
+#define REG_DMA_SRC(dma_no) (*((const void *volatile*) (REG_BASE + ((dma_no&3)*12) + 0x00B0)))
+#define REG_DMA_DST(dma_no) (*((void *volatile*) (REG_BASE + ((dma_no&3)*12) + 0x00B4)))
+#define REG_DMA_CNT(dma_no) (*((volatile u32*) (REG_BASE + ((dma_no&3)*12) + 0x00B8)))
+
 #define REG_TIMER(timer_no) (*((volatile Timer_t*) (REG_BASE+((timer_no&3)<<2) + 0x100)))
 
 
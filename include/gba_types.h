@@ -105,6 +105,8 @@ typedef u32 Tile8[16];
 typedef Tile Charblock[512];
 typedef Tile8 Charblock8[256];
 
+typedef u16 Screenblock[1024];
+
 typedef void (*IRQ_Callback_t)(void);
 
 typedef struct bmp_rect {
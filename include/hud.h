@@ -0,0 +1,50 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _HUD_H_
+#define _HUD_H_
+
+#include <sys/cdefs.h>
+#include "gba_types.h"
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+/*
+ * Text overlay on BG1, over the tiled renderer's maze on BG0. The HUD is
+ * HUD_ROWS lines of HUD_COLS 4px glyphs across the top of the screen, two
+ * glyphs to an 8bpp tile, each tile its own. The glyphs are expanded into
+ * tile rows once, at Hud_Init. Hud_Printf only formats a line into RAM;
+ * Hud_Flush, meant for VBlank, then rewrites just the glyphs whose character
+ * changed, so a HUD that's mostly the same from one update to the next costs
+ * a handful of word stores and never tears. The maze underneath is never
+ * touched; showing or hiding the HUD is one display control bit.
+ * Only the tiled renderer leaves a background free, so Hud_Init fails under
+ * the bitmap renderers and the HUD stays hidden.
+ * */
+
+#define HUD_ROWS 5
+#define HUD_COLS 60
+#define HUD_CBB 1
+// Clear of the glyph tiles in charblock 1 and the tiled renderer's map
+#define HUD_SBB 27
+#ifndef HUD_BG_COLOR
+#define HUD_BG_COLOR 0x0842
+#endif
+
+bool Hud_Init(void);
+void Hud_Close(void);
+bool Hud_Show(bool show);
+bool Hud_Toggle(void);
+bool Hud_Visible(void);
+int Hud_Printf(int row, const char *fmt, ...) __printflike(2,3);
+void Hud_Flush(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _HUD_H_ */
@@ -27,6 +27,12 @@ static inline u16 Key_Pressed(u16 key) {
   return (!(KEY_CURR&key) && (KEY_PREV&key));
 }
 
+#define K_HELD(key) Key_Held(KEY_##key)
+
+static inline u16 Key_Held(u16 key) {
+  return !(KEY_CURR&key);
+}
+
 
 
 
@@ -0,0 +1,152 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _MAZE_H_
+#define _MAZE_H_
+
+#include "gba_types.h"
+#include "maze_observer.h"
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+typedef enum e_direction {
+  NONE_OR_START=0,
+  LEFT=1,
+  RIGHT=2,
+  UP=4,
+  DOWN=8,
+  HORIZONTAL_MASK=3,
+  VERTICAL_MASK=12
+} __attribute__ ((packed)) Direction_e;
+
+typedef enum e_maze_field {
+  MF_LEFT_WALL=1,
+  MF_RIGHT_WALL=2,
+  MF_TOP_WALL=4,
+  MF_BTM_WALL=8,
+  MF_LR_WALLS=3,
+  MF_TB_WALLS=12,
+  MF_EXIT_ARROW=112,
+  MF_INITIALIZED=128
+} __attribute__ ((packed)) MazeField_e;
+// Exit arrows live in the spare bits 4-6 of a grid cell: 0 means no arrow,
+// otherwise (1+log2(direction)), i.e. LEFT=1, RIGHT=2, UP=3, DOWN=4.
+#define MF_EXIT_ARROW_SHIFT 4
+#define COORD(_x,_y) (Coord_t){.x=_x, .y=_y}
+// Cell coordinates get packed into a byte each for the redraw queues
+#define MAZE_DIM_MAX 255
+#define CIDX(coord, gwidth) (coord.x + coord.y*gwidth)
+
+/*
+ * Wall bitplanes; see maze_walls.h for the layout and accessors.
+ * */
+typedef struct s_maze_walls {
+  u32 *right, *bottom;
+  int width, height, row_words;
+} MazeWalls_t;
+
+typedef enum e_maze_gen_id {
+  MG_WILSON=0,
+  MG_WILSON_EXIT_ARROWS,
+  MG_WILSON_HYBRID,
+  MG_ELLER,
+  MG_KRUSKAL,
+  MG_PRIM,
+  MG_BACKTRACKER,
+  MG_MAX
+} MazeGenId_e;
+
+/**
+ * @brief A maze of runtime size. grid is the byte-per-cell MazeField_e grid
+ * the generators carve into, walls the packed copy of it that the solver and
+ * redraws read. Both are sized for width x height when the maze is created.
+ * seed and gen_id record what the current contents were generated from, when
+ * generated through Maze_Generate_Seeded. observer hears about every
+ * algorithm run on the maze; NULL (as created) for no one.
+ * */
+typedef struct s_maze {
+  u8 *grid;
+  MazeWalls_t walls;
+  int width, height;
+  u32 seed;
+  MazeGenId_e gen_id;
+  const MazeObserver_t *observer;
+} Maze_t;
+
+/**
+ * @brief Function table entry for a maze generator. Every engine fills the
+ * maze's grid with the same MazeField_e wall bits, with MF_INITIALIZED set on every
+ * cell once done, and returns false only if it couldn't get its working memory.
+ * */
+typedef struct s_maze_generator {
+  const char *name;
+  bool (*generate)(Maze_t *maze);
+} MazeGenerator_t;
+
+extern const MazeGenerator_t MAZE_GENERATORS[MG_MAX];
+
+/**
+ * @brief Receives one finished maze row from a streaming generator.
+ * row holds grid_width cells in the same MazeField_e format as the grid, and
+ * is only valid for the duration of the call.
+ * */
+typedef void (*Maze_Row_Sink_cb)(const u8 *row, int row_idx, int grid_width, void *userdata);
+
+/**
+ * @brief Remove the wall between cell idx and its neighbour in direction dir,
+ * on both sides. Caller guarantees the neighbour is in bounds.
+ * */
+STAT_INLN void Grid_Carve_Idx(Maze_t *maze, u32 idx, Direction_e dir) {
+  u8 *grid = maze->grid;
+  const int grid_width = maze->width;
+  switch (dir) {
+  case LEFT:
+    grid[idx] ^= MF_LEFT_WALL;
+    grid[idx-1] ^= MF_RIGHT_WALL;
+    break;
+  case RIGHT:
+    grid[idx] ^= MF_RIGHT_WALL;
+    grid[idx+1] ^= MF_LEFT_WALL;
+    break;
+  case UP:
+    grid[idx] ^= MF_TOP_WALL;
+    grid[idx-grid_width] ^= MF_BTM_WALL;
+    break;
+  case DOWN:
+    grid[idx] ^= MF_BTM_WALL;
+    grid[idx+grid_width] ^= MF_TOP_WALL;
+    break;
+  default:
+    break;
+  }
+}
+
+Maze_t *Maze_Create(int width, int height);
+void Maze_Destroy(Maze_t *maze);
+void Grid_Reset(Maze_t *maze);
+
+bool Maze_Generate(MazeGenId_e id, Maze_t *maze);
+bool Maze_Generate_Seeded(MazeGenId_e id, Maze_t *maze, u32 seed);
+u32 Maze_Generate_Timed(MazeGenId_e id, Maze_t *maze);
+void Maze_Generator_Benchmark(Maze_t *maze);
+
+bool Wilsons_Algo(Maze_t *maze);
+bool Wilsons_Algo_Exit_Arrows(Maze_t *maze);
+bool Wilsons_Hybrid_Algo(Maze_t *maze, u32 ab_percent);
+
+bool Ellers_Algo_Stream(int grid_width, int grid_height, Maze_Row_Sink_cb sink, void *userdata);
+bool Ellers_Algo(Maze_t *maze);
+
+bool Kruskals_Algo(Maze_t *maze);
+bool Prims_Algo(Maze_t *maze);
+bool Backtracker_Algo(Maze_t *maze);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _MAZE_H_ */
@@ -0,0 +1,66 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _MAZE_OBSERVER_H_
+#define _MAZE_OBSERVER_H_
+
+#include "gba_types.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * What the maze algorithms report as they go. Generators, graphing and the
+ * solver never draw; they call the hooks of their maze's observer
+ * (Maze_t.observer) through MAZE_OBSERVE, and whoever set the observer up
+ * decides what to show. The observer, and any hook in it, may be NULL.
+ * Building with MAZE_HEADLESS defined swaps in the null observer: every
+ * MAZE_OBSERVE compiles to nothing, arguments and all, so the inner loops
+ * carry no drawing overhead whatsoever. Headless builds leave the renderers,
+ * dirty-cell queue, sprites, HUD and event log out of the link altogether
+ * (see HEADLESS_EXCLUDE in the Makefile).
+ * */
+
+typedef enum e_maze_walk_mark {
+  MWM_OFF=0,
+  MWM_ON,
+  MWM_START
+} MazeWalkMark_e;
+
+typedef struct s_maze_observer {
+  // Cell joined the maze
+  void (*carve)(void *userdata, Coord_t cell);
+  // Generator's walk stepped onto cell (MWM_ON, MWM_START), or backed off
+  // it (MWM_OFF)
+  void (*walk)(void *userdata, Coord_t cell, MazeWalkMark_e mark);
+  // Cell became a graph vertex
+  void (*vertex)(void *userdata, Coord_t cell);
+  // Cell lies on a graph edge
+  void (*edge)(void *userdata, Coord_t cell);
+  // Solver settled the cell's vertex
+  void (*visit)(void *userdata, Coord_t cell);
+  // Solver lowered the distance to the cell's vertex
+  void (*relax)(void *userdata, Coord_t cell);
+  void *userdata;
+} MazeObserver_t;
+
+#ifdef MAZE_HEADLESS
+// Never called, but still type-checked, and its arguments still count as used
+#define MAZE_OBSERVE(maze, hook, ...) do { \
+    if (0) \
+      (maze)->observer->hook((maze)->observer->userdata, __VA_ARGS__); \
+  } while (0)
+#else
+#define MAZE_OBSERVE(maze, hook, ...) do { \
+    const MazeObserver_t *_observer = (maze)->observer; \
+    if (_observer && _observer->hook) \
+      _observer->hook(_observer->userdata, __VA_ARGS__); \
+  } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _MAZE_OBSERVER_H_ */
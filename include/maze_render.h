@@ -0,0 +1,140 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _MAZE_RENDER_H_
+#define _MAZE_RENDER_H_
+
+#include "gba_funcs.h"
+#include "gba_types.h"
+#include "maze.h"
+#include "maze_walls.h"
+#include "render_geometry.h"
+#include "sprite_overlay.h"
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+/*
+ * Maze renderers. Everything that draws maze cells goes through MAZE_RENDERER:
+ *   MAZE_RENDERER_MODE3: the Mode 3 bitmap, a filled rect plus up to four
+ *     wall lines per cell, at any cell size.
+ *   MAZE_RENDERER_MODE4: the same cells on the 8bpp Mode 4 bitmap, drawn
+ *     into the hidden page and shown by flipping pages at present time, so
+ *     half-drawn frames never show. Cells drawn since the last flip are kept
+ *     in a replay ring and redrawn onto the other page after the flip, which
+ *     keeps both pages in step without copying whole pages.
+ *   MAZE_RENDERER_TILED: Mode 0, BG0. One 8x8 tile per cell, picked from the
+ *     16 wall-combination tiles built once into a charblock; the cell's color
+ *     selects a palette bank, so highlighted cells are the same tiles under
+ *     another bank. Drawing a cell is one screen-entry write. Mazes of any
+ *     size show through a screen-sized viewport that Maze_Renderer_Follow
+ *     scrolls with the BG offset registers, streaming in the cells that come
+ *     into view; cells out of view are never written to VRAM.
+ * Maze_Renderer_Use lays the grid out into MAZE_GEOMETRY, which every drawing
+ * hook gets handed, so no renderer divides or multiplies to place a cell.
+ * Call Maze_Renderer_Present (or use Maze_Renderer_VSync for vsync()) once a
+ * frame, in VBlank, to show what's been drawn, sprite markers included.
+ * Maze_Renderer_Snapshot keeps a copy of the clean maze image in EWRAM;
+ * Maze_Renderer_Restore and Maze_Renderer_Restore_Cells then wipe overlays
+ * off it (or part of it) with block copies instead of redrawing cells. Text
+ * output (mode3_printf) still needs Mode 3, so drop back to it with
+ * Maze_Renderer_Release first.
+ * */
+
+// Or into a color to fill the whole cell with it and draw no walls. BGR555
+// leaves bit 15 free for it.
+#define RENDER_CELL_FILL 0x8000
+// Cell colors can also name a state, whose actual color is set with
+// Maze_Renderer_Set_State_Color. The palette renderers give each state its
+// own palette entry, so changing a state's color recolors all its cells at
+// once.
+#define RENDER_CELL_STATE 0x10000
+#define RENDER_STATE_CT 16
+#define RENDER_STATE(state) (RENDER_CELL_STATE | ((state)&(RENDER_STATE_CT-1)))
+#define MAZE_WALL_COLOR 0x10A5
+
+#define TILED_CBB 0
+// Last four screenblocks, clear of the wall tiles in charblock 0
+#define TILED_SBB 28
+// Cells a side of the BG map that the viewport wraps around
+#define TILED_MAP_MAX 64
+#ifndef TILED_FOLLOW_MARGIN
+// Maze_Renderer_Follow scrolls once the cell is closer than this many pixels
+// to an edge of the screen
+#define TILED_FOLLOW_MARGIN 48
+#endif
+
+#ifndef MODE4_REPLAY_CT
+// Cells drawn in one frame past this many and the flip copies the whole page
+#define MODE4_REPLAY_CT 256
+#endif
+
+typedef struct s_maze_renderer {
+  const char *name;
+  // Fixed cell size in pixels, or 0 to fit the grid to the screen
+  int cell_px;
+  // Set the display up for a grid_width x grid_height maze, with every cell
+  // blank. false if the renderer can't show a maze that size.
+  bool (*begin)(int grid_width, int grid_height);
+  // Free whatever begin set up, when switching to another renderer. May be
+  // NULL.
+  void (*end)(void);
+  // cell is the cell's MazeField_e bits
+  void (*draw_cell)(const RenderGeometry_t *geo, Coord_t c, u8 cell, u32 color);
+  // Redraw every cell from walls, all in color
+  void (*draw_walls)(const RenderGeometry_t *geo, const MazeWalls_t *walls, u32 color);
+  // Show what's been drawn so far. NULL if drawing shows up immediately.
+  void (*present)(void);
+  // Copy of what's been drawn so far, malloc'd. NULL if out of memory.
+  void *(*snapshot)(void);
+  // Put image, from snapshot, back over the given cells
+  void (*restore)(const RenderGeometry_t *geo, const void *image, int x, int y, int width, int height);
+  // Recolor cells already drawn in state. NULL if the renderer can't.
+  void (*set_state_color)(int state, u16 color);
+  // Scroll to keep cell in view; returns the view's top left pixel. NULL if
+  // the whole maze is always in view.
+  Coord_t (*follow)(Coord_t cell);
+} MazeRenderer_t;
+
+extern const MazeRenderer_t MAZE_RENDERER_MODE3, MAZE_RENDERER_MODE4, MAZE_RENDERER_TILED;
+extern const MazeRenderer_t *MAZE_RENDERER;
+// Layout of the grid MAZE_RENDERER was set up for
+extern RenderGeometry_t MAZE_GEOMETRY;
+
+bool Maze_Renderer_Use(const MazeRenderer_t *renderer, int grid_width, int grid_height);
+void Maze_Renderer_Release(void);
+bool Maze_Renderer_Snapshot(void);
+void Maze_Renderer_Drop_Snapshot(void);
+bool Maze_Renderer_Restore_Cells(int x, int y, int width, int height);
+bool Maze_Renderer_Restore(void);
+bool Maze_Renderer_Set_State_Color(int state, u16 color);
+u16 Maze_Renderer_State_Color(int state);
+void Maze_Renderer_Cycle_States(int first, int count);
+Coord_t Maze_Renderer_Cell_Size(void);
+void Maze_Renderer_Follow(Coord_t cell);
+void draw_maze_cell(const Maze_t *maze, const Coord_t *coord, u32 color);
+void draw_maze_walls_cell(const MazeWalls_t *walls, const Coord_t *coord, u32 color);
+
+STAT_INLN void Maze_Renderer_Present(void) {
+  Sprite_Overlay_Commit();
+  if (MAZE_RENDERER->present)
+    MAZE_RENDERER->present();
+}
+
+STAT_INLN void Maze_Renderer_VSync(void) {
+  vsync();
+  Maze_Renderer_Present();
+}
+
+void mode3_draw_line(Coord_t start, u32 color, int length, bool vertical);
+void mode4_draw_rect(u16 *page, const BMP_Rect_t *rect);
+void mode4_draw_line(u16 *page, Coord_t start, u8 clr_idx, int length, bool vertical);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _MAZE_RENDER_H_ */
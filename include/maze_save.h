@@ -0,0 +1,65 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _MAZE_SAVE_H_
+#define _MAZE_SAVE_H_
+
+#include "gba_types.h"
+#include "maze.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Maze storage in the 64 KB SRAM save area. Layout:
+ *   0x0000  MazeSaveHeader_t
+ *   0x0010  MazeSaveEntry_t index[MAZE_SAVE_SLOT_CT]
+ *   0x0410  packed maze data, allocated bottom-up in entry order
+ * Two formats:
+ *   MSF_PACKED: two bits per cell (bit 0 right wall, bit 1 bottom wall), cells
+ *     row-major, four to a byte. ceil(w*h/4) bytes, and loading is a copy.
+ *   MSF_SEED: just the seed and generator id; loading regenerates the maze
+ *     through Maze_Generate_Seeded. No data bytes at all.
+ * Shares SRAM with the _DEBUG_LOG_TO_SAVEFILE_ log, so don't use both.
+ * */
+
+#define MAZE_SAVE_MAGIC 0x31535A4DUL  // "MZS1"
+#define MAZE_SAVE_SLOT_CT 64
+
+typedef enum e_maze_save_format {
+  MSF_NONE=0,
+  MSF_PACKED,
+  MSF_SEED,
+} MazeSaveFormat_e;
+
+typedef struct s_maze_save_header {
+  u32 magic;
+  u16 entry_ct;
+  u16 data_end;
+  u32 reserved[2];
+} MazeSaveHeader_t;
+
+typedef struct s_maze_save_entry {
+  u32 seed;
+  u16 data_ofs, data_len;
+  u16 width, height;
+  u8 format, gen_id;
+  // Fletcher-16 over the packed bytes (MSF_PACKED only)
+  u16 checksum;
+} MazeSaveEntry_t;
+
+bool Maze_Save_Init(void);
+void Maze_Save_Clear(void);
+int Maze_Save_Count(void);
+bool Maze_Save_Get_Entry(int slot, MazeSaveEntry_t *entry);
+int Maze_Save_Find(int width, int height);
+int Maze_Save_Store(const Maze_t *maze, MazeSaveFormat_e format);
+bool Maze_Save_Load(int slot, Maze_t *maze);
+bool Maze_Save_Delete(int slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _MAZE_SAVE_H_ */
@@ -0,0 +1,108 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _MAZE_WALLS_H_
+#define _MAZE_WALLS_H_
+
+#include "gba_types.h"
+#include "gba_util_macros.h"
+#include "maze.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Maze walls as two bitplanes: bit x of row y in right is set if cell (x, y)
+ * has a wall on its right, and likewise for bottom. A cell's left/top walls
+ * are its neighbour's right/bottom walls (or the border), so every interior
+ * wall is stored exactly once. Rows are padded out to whole u32 words so a
+ * row can be scanned or rewritten a word (32 cells) at a time, and padding
+ * bits are kept set. MazeWalls_t itself is declared in maze.h.
+ * */
+bool Maze_Walls_Init(MazeWalls_t *walls, int grid_width, int grid_height);
+void Maze_Walls_Close(MazeWalls_t *walls);
+void Maze_Walls_From_Grid(MazeWalls_t *walls, const u8 *grid);
+void Maze_Walls_To_Grid(const MazeWalls_t *walls, u8 *grid);
+
+STAT_INLN u32 *Maze_Walls_Right_Row(const MazeWalls_t *walls, int y) {
+  return walls->right + y*walls->row_words;
+}
+
+STAT_INLN u32 *Maze_Walls_Bottom_Row(const MazeWalls_t *walls, int y) {
+  return walls->bottom + y*walls->row_words;
+}
+
+STAT_INLN bool Maze_Walls_Right(const MazeWalls_t *walls, int x, int y) {
+  return (Maze_Walls_Right_Row(walls, y)[x>>5]>>(x&31))&1;
+}
+
+STAT_INLN bool Maze_Walls_Bottom(const MazeWalls_t *walls, int x, int y) {
+  return (Maze_Walls_Bottom_Row(walls, y)[x>>5]>>(x&31))&1;
+}
+
+/**
+ * @brief Whether leaving cell (x, y) in direction dir runs into a wall.
+ * The outer border always counts as a wall.
+ * */
+STAT_INLN bool Maze_Walls_Blocked(const MazeWalls_t *walls, int x, int y, Direction_e dir) {
+  switch (dir) {
+  case LEFT:
+    return !x || Maze_Walls_Right(walls, x-1, y);
+  case RIGHT:
+    return Maze_Walls_Right(walls, x, y);
+  case UP:
+    return !y || Maze_Walls_Bottom(walls, x, y-1);
+  case DOWN:
+    return Maze_Walls_Bottom(walls, x, y);
+  default:
+    return true;
+  }
+}
+
+/**
+ * @brief Rebuild the MazeField_e wall nibble (MF_LEFT_WALL..MF_BTM_WALL) for
+ * cell (x, y), for code that still wants all four walls at once.
+ * */
+STAT_INLN u8 Maze_Walls_Cell(const MazeWalls_t *walls, int x, int y) {
+  u8 ret = 0;
+  if (Maze_Walls_Blocked(walls, x, y, LEFT))
+    ret |= MF_LEFT_WALL;
+  if (Maze_Walls_Right(walls, x, y))
+    ret |= MF_RIGHT_WALL;
+  if (Maze_Walls_Blocked(walls, x, y, UP))
+    ret |= MF_TOP_WALL;
+  if (Maze_Walls_Bottom(walls, x, y))
+    ret |= MF_BTM_WALL;
+  return ret;
+}
+
+/**
+ * @brief Remove the wall between (x, y) and its neighbour in direction dir.
+ * Single bit clear, since the wall is only stored once. Caller guarantees the
+ * neighbour is in bounds.
+ * */
+STAT_INLN void Maze_Walls_Carve(MazeWalls_t *walls, int x, int y, Direction_e dir) {
+  switch (dir) {
+  case LEFT:
+    --x;
+    // fall through
+  case RIGHT:
+    Maze_Walls_Right_Row(walls, y)[x>>5] &= ~(1U<<(x&31));
+    break;
+  case UP:
+    --y;
+    // fall through
+  case DOWN:
+    Maze_Walls_Bottom_Row(walls, y)[x>>5] &= ~(1U<<(x&31));
+    break;
+  default:
+    break;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _MAZE_WALLS_H_ */
@@ -15,8 +15,12 @@ extern "C" {
 int mode3_printf(int x, int y, unsigned short bg_clr, const char *restrict fmt, ...)
   __printflike(4,5);
 
+int mode3_puts(int x, int y, unsigned short bg_clr, const char *str);
+
 void mode3_putchar(int c, int x, int y, unsigned short bg_color);
 
+void mode3_glyph_cache_flush(void);
+
 
 
 #ifdef __cplusplus
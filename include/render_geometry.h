@@ -0,0 +1,43 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _RENDER_GEOMETRY_H_
+#define _RENDER_GEOMETRY_H_
+
+#include "gba_types.h"
+#include "maze.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Where a maze's cells land on screen, worked out once per maze so that
+ * placing a cell is table lookups only. The GBA has no divide instruction
+ * (every / is a BIOS or libgcc call) and drawing runs per cell, so nothing
+ * past Render_Geometry_Init divides or multiplies to find a cell.
+ * */
+
+typedef struct s_render_geometry {
+  int grid_w, grid_h;
+  // Cell size in pixels
+  int cell_w, cell_h;
+  // Wall spans: horizontal walls run hwall_len pixels and vertical ones
+  // vwall_len; the right and bottom walls sit right_ofs and btm_ofs pixels
+  // in from the cell's top left
+  int hwall_len, vwall_len, right_ofs, btm_ofs;
+  // Left pixel of column x and top pixel of row y. col_x[grid_w] and
+  // row_y[grid_h] are the edge past the last cell, so a run of cells spans
+  // col_x[x+width] - col_x[x] pixels.
+  u16 col_x[MAZE_DIM_MAX+1], row_y[MAZE_DIM_MAX+1];
+  // Index of row y's first cell, i.e. y*grid_w
+  u16 row_cell[MAZE_DIM_MAX+1];
+} RenderGeometry_t;
+
+void Render_Geometry_Init(RenderGeometry_t *geo, int grid_width, int grid_height, int cell_px);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _RENDER_GEOMETRY_H_ */
@@ -0,0 +1,92 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _RNG_H_
+#define _RNG_H_
+
+#include "gba_types.h"
+#include "gba_util_macros.h"
+#include "maze.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * xoshiro128** generator. Only fixed-width unsigned adds, shifts, rotates and
+ * a 32x32->64 multiply are used, so a given (seed, stream) pair produces the
+ * same sequence on the GBA and on any host, unlike newlib's rand().
+ * Small draws (coin flips, directions) are served out of a buffered word so
+ * one Rng_Next() call covers 32 coin flips or 16 directions.
+ * */
+typedef struct s_rng {
+  u32 s[4];
+  u32 bits;
+  u32 bits_left;
+} Rng_t;
+
+/* Independent stream ids. Seeding the same seed under two stream ids gives
+ * two unrelated sequences, so consumers don't perturb one another. */
+typedef enum e_rng_stream {
+  RNG_STREAM_MAZE=0,
+  RNG_STREAM_MAX,
+} RngStream_e;
+
+extern Rng_t MAZE_RNG;
+
+void Rng_Seed(Rng_t *rng, u32 seed, u32 stream);
+
+STAT_INLN u32 Rng_Rotl(u32 x, int k) {
+  return (x<<k)|(x>>(32-k));
+}
+
+STAT_INLN u32 Rng_Next(Rng_t *rng) {
+  u32 *s = rng->s;
+  const u32 result = Rng_Rotl(s[1]*5, 7)*9, t = s[1]<<9;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = Rng_Rotl(s[3], 11);
+  return result;
+}
+
+/**
+ * @brief Uniform-ish value in [0, range) by multiply-shift instead of modulo,
+ * as there's no hardware divide on the GBA. Bias is below range/2^32.
+ * */
+STAT_INLN u32 Rng_Range(Rng_t *rng, u32 range) {
+  return (u32)(((u64)Rng_Next(rng)*range)>>32);
+}
+
+/**
+ * @brief Take the next n (1 to 31) bits from the buffered word, refilling it
+ * when it runs dry.
+ * */
+STAT_INLN u32 Rng_Bits(Rng_t *rng, u32 n) {
+  u32 ret;
+  if (rng->bits_left < n) {
+    rng->bits = Rng_Next(rng);
+    rng->bits_left = 32;
+  }
+  ret = rng->bits&((1U<<n)-1);
+  rng->bits >>= n;
+  rng->bits_left -= n;
+  return ret;
+}
+
+STAT_INLN bool Rng_Coin(Rng_t *rng) {
+  return Rng_Bits(rng, 1);
+}
+
+STAT_INLN Direction_e Rng_Dir(Rng_t *rng) {
+  static const Direction_e DIRS[4] = {LEFT, RIGHT, UP, DOWN};
+  return DIRS[Rng_Bits(rng, 2)];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _RNG_H_ */
@@ -0,0 +1,63 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include "gba_types.h"
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+/*
+ * Cooperative, frame-budgeted task runner. A task is a step function over
+ * some state; each step does a small bounded unit of work and returns whether
+ * there's more to do. Once per frame the scheduler calls step repeatedly
+ * until the task's cycle budget (timed with the timer 2/3 cycle counter) runs
+ * out, runs the per-frame hook (input, HUD, ...), then sleeps until the next
+ * VBlank and runs the VBlank hook (VRAM updates). Frames are counted by a
+ * VBlank IRQ callback, so overruns show up in a task's frame count too.
+ * The budget is only checked between steps, so a task is only as well sliced
+ * as its steps are small. Of the generators, only plain Wilson's (MG_WILSON)
+ * steps a walk at a time; the Wilson variants, Eller's, Kruskal's, Prim's and
+ * the backtracker have no resumable form and finish in one step, overrunning
+ * the budget by however long that takes on a large maze.
+ * */
+
+typedef enum e_task_status {
+  TASK_RUNNING=0,
+  TASK_DONE,
+  TASK_FAILED,
+} TaskStatus_e;
+
+typedef TaskStatus_e (*Task_Step_cb)(void *state);
+typedef void (*Scheduler_Frame_cb)(void *userdata);
+
+typedef struct s_task {
+  const char *name;
+  Task_Step_cb step;
+  void *state;
+  // Filled in by Scheduler_Run, and kept current while it runs. cycles
+  // counts only the time spent in step.
+  u32 frames, steps, cycles;
+} Task_t;
+
+// About 3/4 of a frame (280896 cycles), leaving the rest for the frame hook
+// and drawing that happens inside steps
+#define SCHEDULER_DEFAULT_BUDGET 200000
+
+extern volatile u32 SCHEDULER_FRAME_CT;
+
+void Scheduler_Init(u32 cycle_budget, Scheduler_Frame_cb frame_hook, void *userdata);
+void Scheduler_Set_Budget(u32 cycle_budget);
+void Scheduler_Set_VBlank_Hook(Scheduler_Frame_cb hook_cb, void *userdata);
+TaskStatus_e Scheduler_Run(Task_t *task);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _SCHEDULER_H_ */
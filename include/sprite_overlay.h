@@ -0,0 +1,48 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#ifndef _SPRITE_OVERLAY_H_
+#define _SPRITE_OVERLAY_H_
+
+#include "gba_types.h"
+#include "render_geometry.h"
+#ifdef __cplusplus
+extern "C" {
+#else
+#include <stdbool.h>
+#endif
+
+/*
+ * 8x8 sprite markers over the maze, one per OAM object. Placing or hiding a
+ * marker only writes its attributes into a shadow copy of OAM in RAM;
+ * Sprite_Overlay_Commit DMAs the shadow into OAM, and only once something has
+ * changed, so moving a marker never touches the maze underneath. Commit runs
+ * from Maze_Renderer_Present, i.e. once per VBlank.
+ * */
+
+#define OVERLAY_OBJ_CT 128
+// Mode 3 and 4 bitmaps run into the lower half of OBJ VRAM, so marker tiles
+// go from the first tile past them, which every video mode can use
+#define OVERLAY_TILE 512
+
+typedef enum e_overlay_marker {
+  OM_CURRENT=0,
+  OM_FRONTIER,
+  OM_PATH_HEAD,
+  OM_MAX
+} OverlayMarker_e;
+
+void Sprite_Overlay_Init(const RenderGeometry_t *geometry);
+void Sprite_Overlay_Close(void);
+void Sprite_Overlay_Place(int obj, OverlayMarker_e marker, Coord_t cell);
+void Sprite_Overlay_Hide(int obj);
+void Sprite_Overlay_Hide_All(void);
+void Sprite_Overlay_Set_Origin(Coord_t view);
+void Sprite_Overlay_Commit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _SPRITE_OVERLAY_H_ */
@@ -11,6 +11,8 @@ void __assert_func(const char *src_filename, int line_no, const char *caller, co
   (*((volatile u16 *)(0x04000000 + 0x0208))) = 0;
   (*((IRQ_Callback_t *)(0x03007FFC))) = ((void *)0);
   (*((volatile u16 *)(0x04000000 + 0x0200))) ^= 1;
+  // Back to Mode 3 in case a tiled renderer had the display
+  (*((volatile u32 *)(0x04000000))) = 0x0403;
   mode3_printf(0, 0, 0x1069,
                "[Error]:\x1b[0x10A5] Assertion expression, \x1b[0x2483]"
                "%s"
@@ -440,7 +440,8 @@ void BinaryTree_RemoveAll(BinaryTree_t *tree) {
   dynamic_data = 0!=tree->alloc_size;
   if ((size_t)0 == nmemb)
     return;
-  BinaryTreeNode_t *stack[tree->nmemb], *cur;
+  // One slot per node plus one, as the NULL links below leaves get pushed too
+  BinaryTreeNode_t *stack[tree->nmemb+1], *cur;
   int top = -1;
   stack[++top] = tree->root;
   do {
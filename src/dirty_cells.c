@@ -0,0 +1,175 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_funcs.h"
+#include "gba_mmap.h"
+#include "gba_types.h"
+#include "dirty_cells.h"
+#include "maze.h"
+#include "maze_render.h"
+#include <stdlib.h>
+#include <assert.h>
+
+DirtyCellsStats_t DIRTY_CELLS_STATS = {0};
+
+static const Maze_t *tracked = NULL;
+// One bit per cell: already queued
+static u32 *pending = NULL;
+// Per cell index into palette of the color it was last marked with. Only
+// meaningful while the cell's pending bit is set.
+static u8 *color_slots = NULL;
+// Ring of queued cells, packed as x | y<<8 (both fit in a byte at up to one
+// cell per pixel), so flushing never divides to recover a coordinate
+static u16 *queue = NULL;
+static u32 queue_head = 0, queue_ct = 0, queue_cap = 0;
+// Slots 0 to RENDER_STATE_CT-1 are the render states', fixed; plain colors
+// claim the rest as they first get marked
+static u32 palette[DIRTY_COLOR_CT];
+static int palette_ct = RENDER_STATE_CT, last_slot = RENDER_STATE_CT;
+
+STAT_INLN void Dirty_Cell_Draw(const Maze_t *maze, Coord_t c, u32 color) {
+  MAZE_RENDERER->draw_cell(&MAZE_GEOMETRY, c, maze->grid[CIDX(c, maze->width)], color);
+}
+
+/**
+ * @return color's palette slot, or -1 if the palette is full.
+ * */
+STAT_INLN int Dirty_Color_Slot(u32 color) {
+  if (color&RENDER_CELL_STATE)
+    return color&(RENDER_STATE_CT-1);
+  if (palette_ct > RENDER_STATE_CT && palette[last_slot]==color)
+    return last_slot;
+  for (int i = RENDER_STATE_CT; i < palette_ct; ++i) {
+    if (palette[i]==color)
+      return last_slot = i;
+  }
+  if (palette_ct==DIRTY_COLOR_CT)
+    return -1;
+  palette[palette_ct] = color;
+  return last_slot = palette_ct++;
+}
+
+/**
+ * @brief Start tracking maze's cells, with nothing pending. Replaces any maze
+ * tracked before.
+ * @return false if allocation fails.
+ * */
+bool Dirty_Cells_Init(const Maze_t *maze) {
+  const u32 CELL_CT = maze->width*maze->height;
+  const u32 BITSET_WORDS = (CELL_CT+31)>>5;
+  Dirty_Cells_Close();
+  queue_cap = CELL_CT < DIRTY_QUEUE_CAP ? CELL_CT : DIRTY_QUEUE_CAP;
+  // Bitset first, so it stays word aligned
+  pending = calloc(1, BITSET_WORDS*sizeof(u32) + queue_cap*sizeof(u16) + CELL_CT);
+  if (!pending)
+    return false;
+  queue = (u16*)(pending + BITSET_WORDS);
+  color_slots = (u8*)(queue + queue_cap);
+  queue_head = queue_ct = 0;
+  palette_ct = last_slot = RENDER_STATE_CT;
+  for (int i = 0; i < RENDER_STATE_CT; ++i)
+    palette[i] = RENDER_STATE(i);
+  DIRTY_CELLS_STATS = (DirtyCellsStats_t){0};
+  tracked = maze;
+  return true;
+}
+
+void Dirty_Cells_Close(void) {
+  // Queue and color slots share the bitset's allocation
+  free(pending);
+  pending = NULL;
+  queue = NULL;
+  color_slots = NULL;
+  tracked = NULL;
+  queue_ct = queue_cap = 0;
+}
+
+/**
+ * @brief Queue the cell at coord to be drawn in color at the next flush. If
+ * it's already queued, just update the color it will be drawn in.
+ * */
+void Dirty_Cells_Mark(const Maze_t *maze, const Coord_t *coord, u32 color) {
+  Coord_t c = *coord;
+  int slot;
+  if (c.x < 0 || c.y < 0 || c.x >= maze->width || c.y >= maze->height)
+    return;
+  if (maze!=tracked) {
+    Dirty_Cell_Draw(maze, c, color);
+    return;
+  }
+  slot = Dirty_Color_Slot(color);
+  assert(slot >= 0);  // Out of plain colors; raise DIRTY_RAW_COLOR_CT
+  if (slot < 0) {
+    Dirty_Cell_Draw(maze, c, color);
+    return;
+  }
+  const u32 IDX = CIDX(c, maze->width);
+  ++DIRTY_CELLS_STATS.marked;
+  color_slots[IDX] = slot;
+  if (pending[IDX>>5]&(1UL<<(IDX&31))) {
+    ++DIRTY_CELLS_STATS.merged;
+    return;
+  }
+  if (queue_ct==queue_cap) {
+    ++DIRTY_CELLS_STATS.overflowed;
+    Dirty_Cell_Draw(maze, c, color);
+    return;
+  }
+  pending[IDX>>5] |= 1UL<<(IDX&31);
+  u32 tail = queue_head + queue_ct++;
+  if (tail >= queue_cap)
+    tail -= queue_cap;
+  queue[tail] = c.x | (c.y<<8);
+}
+
+u32 Dirty_Cells_Pending(void) {
+  return queue_ct;
+}
+
+STAT_INLN void Dirty_Cells_Pop_Draw(void) {
+  const Coord_t C = COORD(queue[queue_head]&0xFF, queue[queue_head]>>8);
+  const u32 IDX = CIDX(C, tracked->width);
+  if (++queue_head==queue_cap)
+    queue_head = 0;
+  --queue_ct;
+  pending[IDX>>5] &= ~(1UL<<(IDX&31));
+  Dirty_Cell_Draw(tracked, C, palette[color_slots[IDX]]);
+  ++DIRTY_CELLS_STATS.drawn;
+}
+
+/**
+ * @brief Draw queued cells, oldest first, for as long as the display stays in
+ * VBlank and short of scanline vcount_end. Does nothing outside VBlank, so
+ * call it right after vsync().
+ * @return number of cells drawn.
+ * */
+u32 Dirty_Cells_Flush(u32 vcount_end) {
+  u32 drawn = 0, vcount;
+  while (queue_ct) {
+    vcount = REG_DISPLAY_VCOUNT;
+    if (vcount < SCREEN_HEIGHT || vcount >= vcount_end)
+      break;
+    Dirty_Cells_Pop_Draw();
+    ++drawn;
+  }
+  return drawn;
+}
+
+/**
+ * @brief Draw every queued cell right now, VBlank or not.
+ * */
+void Dirty_Cells_Flush_All(void) {
+  while (queue_ct)
+    Dirty_Cells_Pop_Draw();
+}
+
+/**
+ * @brief Flush across as many VBlanks as it takes to empty the queue.
+ * */
+void Dirty_Cells_Drain(void) {
+  while (queue_ct) {
+    Maze_Renderer_VSync();
+    Dirty_Cells_Flush(DIRTY_FLUSH_VCOUNT_END);
+  }
+}
@@ -0,0 +1,97 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_dma.h"
+#include "gba_mmap.h"
+#include "gba_types.h"
+#include <stdint.h>
+
+// DMA3's count field is 16 bits, with 0 meaning 0x10000
+#define DMA3_MAX_COUNT 0x10000UL
+
+static volatile u32 fill_value;
+static DmaFill_t fill_queue[DMA_FILL_QUEUE_CT];
+static u32 fill_ct = 0;
+
+static void DMA3_Fill(void *dst, u32 count, u32 mode, u32 unit_size) {
+  u8 *d = dst;
+  while (count) {
+    u32 chunk = count < DMA3_MAX_COUNT ? count : DMA3_MAX_COUNT;
+    DMA3_Transfer(d, (const void*)&fill_value, chunk&0xFFFF, mode|DMA_SRC_FIXED|DMA_DST_INC|DMA_NOW);
+    d += chunk*unit_size;
+    count -= chunk;
+  }
+}
+
+void DMA3_Fill16(void *dst, u16 value, u32 hword_ct) {
+  fill_value = value;
+  DMA3_Fill(dst, hword_ct, DMA_16, 2);
+}
+
+void DMA3_Fill32(void *dst, u32 value, u32 word_ct) {
+  fill_value = value;
+  DMA3_Fill(dst, word_ct, DMA_32, 4);
+}
+
+/**
+ * @brief Queue a fill of count halfwords (or words, if words) at dst with
+ * value. If the queue is full, what's queued so far runs first.
+ * */
+void DMA_Fill_Push(void *dst, u32 value, u32 count, bool words) {
+  if (!count || count > DMA3_MAX_COUNT)
+    return;
+  if (fill_ct==DMA_FILL_QUEUE_CT)
+    DMA_Fill_Submit();
+  fill_queue[fill_ct++] = (DmaFill_t){
+    .dst = dst, .value = value,
+    .cnt = (count&0xFFFF) | (words ? DMA_32 : DMA_16) | DMA_SRC_FIXED | DMA_DST_INC | DMA_NOW
+  };
+}
+
+u32 DMA_Fill_Pending(void) {
+  return fill_ct;
+}
+
+/**
+ * @brief Run every queued fill, back-to-back, in the order pushed.
+ * */
+void DMA_Fill_Submit(void) {
+  for (u32 i = 0; i < fill_ct; ++i) {
+    REG_DMA_CNT(3) = 0;
+    REG_DMA_SRC(3) = &fill_queue[i].value;
+    REG_DMA_DST(3) = fill_queue[i].dst;
+    REG_DMA_CNT(3) = fill_queue[i].cnt | DMA_ENABLE;
+  }
+  fill_ct = 0;
+}
+
+/**
+ * @brief Queue a fill of hword_ct halfwords at dst, as word transfers with at
+ * most one halfword at either end stored by the CPU straight away. The CPU
+ * stores don't wait for the submit, so don't draw over the span in between.
+ * */
+void DMA_Fill_Span16(u16 *dst, u16 value, u32 hword_ct) {
+  if (((uintptr_t)dst&2) && hword_ct) {
+    *dst++ = value;
+    --hword_ct;
+  }
+  if (hword_ct&1)
+    dst[hword_ct-1] = value;
+  if (hword_ct>>1)
+    DMA_Fill_Push(dst, value|((u32)value<<16), hword_ct>>1, true);
+}
+
+/**
+ * @brief Queue the rows of rect in the 16-bit framebuffer fb, stride
+ * halfwords a row. A rect spanning whole rows is queued as a single span.
+ * */
+void DMA_Fill_Rect16(u16 *fb, int stride, const BMP_Rect_t *rect) {
+  u16 *row = fb + rect->x + rect->y*stride;
+  if ((int)rect->width==stride) {
+    DMA_Fill_Span16(row, rect->color, rect->width*rect->height);
+    return;
+  }
+  for (u32 h = rect->height; h--; row += stride)
+    DMA_Fill_Span16(row, rect->color, rect->width);
+}
@@ -0,0 +1,162 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_types.h"
+#include "maze.h"
+#include "rng.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*
+ * Eller's algorithm state for a single row. Every column belongs to a set,
+ * identified by a label in [1, grid_width]. Members of a set within the row
+ * are chained into a circular list through ring[], so that merging two sets
+ * is a splice plus a relabel of only the absorbed set's members. Labels freed
+ * by merges go back into the free_labels pool and get handed to columns that
+ * start a fresh set.
+ * */
+typedef struct s_eller_row {
+  u16 *labels, *ring, *next_ring, *free_labels;
+  u8 *cells, *done;
+  u16 free_ct;
+} EllerRow_t;
+
+STAT_INLN void Eller_Merge(EllerRow_t *row, int keep_col, int absorb_col) {
+  u16 keep = row->labels[keep_col], absorbed = row->labels[absorb_col], tmp;
+  int col = absorb_col;
+  do {
+    row->labels[col] = keep;
+    col = row->ring[col];
+  } while (col != absorb_col);
+  // Swapping successors of one node from each circular list joins the lists
+  tmp = row->ring[keep_col];
+  row->ring[keep_col] = row->ring[absorb_col];
+  row->ring[absorb_col] = tmp;
+  row->free_labels[row->free_ct++] = absorbed;
+}
+
+/**
+ * @brief Generate a grid_width x grid_height maze one row at a time with
+ * Eller's algorithm, handing each finished row to sink as soon as it is done.
+ * Only O(grid_width) memory is held, allocated once up front, so the maze can
+ * be far taller than would fit in RAM as a whole grid, and each row costs the
+ * same to produce.
+ * @return false if the row state couldn't be allocated.
+ * */
+bool Ellers_Algo_Stream(int grid_width, int grid_height, Maze_Row_Sink_cb sink, void *userdata) {
+  if (grid_width <= 0 || grid_height <= 0 || grid_width > 0xFFFF || !sink)
+    return false;
+  const size_t W = grid_width;
+  EllerRow_t row;
+  u8 *block = malloc(W*(4*sizeof(u16) + 2*sizeof(u8)));
+  if (!block)
+    return false;
+  row.labels = (u16*)block;
+  row.ring = row.labels + W;
+  row.next_ring = row.ring + W;
+  row.free_labels = row.next_ring + W;
+  row.cells = (u8*)(row.free_labels + W);
+  row.done = row.cells + W;
+
+  memset(row.labels, 0, W*sizeof(u16));
+  row.free_ct = 0;
+  for (size_t lbl = W; lbl; --lbl)
+    row.free_labels[row.free_ct++] = lbl;
+
+  for (int y = 0; y < grid_height; ++y) {
+    const bool last_row = y == grid_height-1;
+    // Columns carried down from the previous row keep their set and have no
+    // top wall. Everything else starts a fresh singleton set.
+    for (int x = 0; x < grid_width; ++x) {
+      row.cells[x] = MF_INITIALIZED|MF_LR_WALLS|MF_TB_WALLS;
+      if (row.labels[x]) {
+        row.cells[x] ^= MF_TOP_WALL;
+        continue;
+      }
+      assert(row.free_ct!=0);
+      row.labels[x] = row.free_labels[--row.free_ct];
+      row.ring[x] = x;
+    }
+
+    for (int x = 0; x+1 < grid_width; ++x) {
+      if (row.labels[x]==row.labels[x+1])
+        continue;
+      // The last row must join every remaining set to close the maze off
+      if (!last_row && Rng_Coin(&MAZE_RNG))
+        continue;
+      Eller_Merge(&row, x, x+1);
+      row.cells[x] ^= MF_RIGHT_WALL;
+      row.cells[x+1] ^= MF_LEFT_WALL;
+    }
+
+    if (last_row) {
+      sink(row.cells, y, grid_width, userdata);
+      break;
+    }
+
+    // Each set must carry on into the next row through at least one column.
+    // Walk each set's ring once, choosing columns to carve down at random and
+    // rebuilding the ring from only the carried columns for the next row.
+    memset(row.done, 0, W);
+    for (int x = 0; x < grid_width; ++x) {
+      if (row.done[x])
+        continue;
+      int col = x, first = -1, prev = -1, members = 0, fallback = x;
+      do {
+        row.done[col] = 1;
+        // Reservoir-pick a member to carve if the coin flips never do
+        if (!Rng_Range(&MAZE_RNG, ++members))
+          fallback = col;
+        if (Rng_Coin(&MAZE_RNG)) {
+          row.cells[col] ^= MF_BTM_WALL;
+          if (prev < 0)
+            first = col;
+          else
+            row.next_ring[prev] = col;
+          prev = col;
+        }
+        col = row.ring[col];
+      } while (col != x);
+      if (prev < 0) {
+        row.cells[fallback] ^= MF_BTM_WALL;
+        first = prev = fallback;
+      }
+      row.next_ring[prev] = first;
+    }
+
+    sink(row.cells, y, grid_width, userdata);
+
+    // Columns that didn't carve down start the next row unlabelled. Their set
+    // lives on through its carried columns, so no label is freed here.
+    for (int x = 0; x < grid_width; ++x) {
+      if (row.cells[x]&MF_BTM_WALL)
+        row.labels[x] = 0;
+    }
+    {
+      u16 *tmp = row.ring;
+      row.ring = row.next_ring;
+      row.next_ring = tmp;
+    }
+  }
+  free(block);
+  return true;
+}
+
+static void Eller_Grid_Row_Sink(const u8 *row, int row_idx, int grid_width, void *userdata) {
+  const Maze_t *maze = userdata;
+  u8 *grid_row = maze->grid + row_idx*grid_width;
+  memcpy(grid_row, row, grid_width);
+  for (Coord_t c = COORD(0, row_idx); c.x < grid_width; ++c.x) {
+    MAZE_OBSERVE(maze, carve, c);
+  }
+}
+
+/**
+ * @brief Eller's algorithm into a whole in-memory grid, logging each row as
+ * it comes in. Convenience wrapper around Ellers_Algo_Stream.
+ * */
+bool Ellers_Algo(Maze_t *maze) {
+  return Ellers_Algo_Stream(maze->width, maze->height, Eller_Grid_Row_Sink, maze);
+}
@@ -0,0 +1,161 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_types.h"
+#include "event_log.h"
+#include <stdlib.h>
+
+EventLogStats_t EVENT_LOG_STATS = {0};
+
+static MazeEvent_t *ring = NULL;
+static u32 ring_head = 0, ring_ct = 0;
+static Event_Play_cb play = NULL;
+static void *play_userdata = NULL;
+// Rate in events a second, and events' worth of ticks banked so far, in
+// 1/EVENT_TICK_RATE events
+static u32 rate = EVENT_TICK_RATE, credit = 0;
+static bool fast_forward = false, skipping = false;
+
+/**
+ * @brief Start recording, with events played through play_cb. Replaces any
+ * log set up before, pending events and all.
+ * @return false if allocation fails.
+ * */
+bool Event_Log_Init(Event_Play_cb play_cb, void *userdata) {
+  Event_Log_Close();
+  if (!(ring = malloc(EVENT_LOG_CAP*sizeof(MazeEvent_t))))
+    return false;
+  ring_head = ring_ct = 0;
+  play = play_cb;
+  play_userdata = userdata;
+  credit = 0;
+  fast_forward = skipping = false;
+  EVENT_LOG_STATS = (EventLogStats_t){0};
+  return true;
+}
+
+void Event_Log_Close(void) {
+  free(ring);
+  ring = NULL;
+  play = NULL;
+  ring_ct = 0;
+}
+
+STAT_INLN void Event_Log_Play_Oldest(bool overflow) {
+  const MazeEvent_t EVENT = ring[ring_head];
+  if (++ring_head==EVENT_LOG_CAP)
+    ring_head = 0;
+  --ring_ct;
+  ++EVENT_LOG_STATS.played;
+  play(&EVENT, overflow, play_userdata);
+}
+
+/**
+ * @brief Record an event for cell, to be played in turn.
+ * */
+void Event_Log_Push(MazeEventType_e type, Coord_t cell, u8 arg) {
+  if (!ring)
+    return;
+  if (ring_ct==EVENT_LOG_CAP) {
+    ++EVENT_LOG_STATS.overflowed;
+    Event_Log_Play_Oldest(true);
+  }
+  u32 tail = ring_head + ring_ct++;
+  if (tail >= EVENT_LOG_CAP)
+    tail -= EVENT_LOG_CAP;
+  ring[tail] = (MazeEvent_t){.type = type, .x = cell.x, .y = cell.y, .arg = arg};
+  ++EVENT_LOG_STATS.pushed;
+}
+
+u32 Event_Log_Pending(void) {
+  return ring_ct;
+}
+
+static void Event_Log_Carve(void *userdata, Coord_t cell) {
+  (void)userdata;
+  Event_Log_Push(ME_CARVE, cell, 0);
+}
+
+static void Event_Log_Walk(void *userdata, Coord_t cell, MazeWalkMark_e mark) {
+  (void)userdata;
+  Event_Log_Push(ME_WALK, cell, mark);
+}
+
+static void Event_Log_Vertex(void *userdata, Coord_t cell) {
+  (void)userdata;
+  Event_Log_Push(ME_VERTEX, cell, 0);
+}
+
+static void Event_Log_Edge(void *userdata, Coord_t cell) {
+  (void)userdata;
+  Event_Log_Push(ME_EDGE, cell, 0);
+}
+
+static void Event_Log_Visit(void *userdata, Coord_t cell) {
+  (void)userdata;
+  Event_Log_Push(ME_VISIT, cell, 0);
+}
+
+static void Event_Log_Relax(void *userdata, Coord_t cell) {
+  (void)userdata;
+  Event_Log_Push(ME_RELAX, cell, 0);
+}
+
+const MazeObserver_t EVENT_LOG_OBSERVER = {
+  .carve = Event_Log_Carve,
+  .walk = Event_Log_Walk,
+  .vertex = Event_Log_Vertex,
+  .edge = Event_Log_Edge,
+  .visit = Event_Log_Visit,
+  .relax = Event_Log_Relax,
+};
+
+/**
+ * @brief Play events_per_sec events a second from now on, and stop skipping
+ * and fast-forwarding.
+ * */
+void Event_Player_Set_Rate(u32 events_per_sec) {
+  rate = events_per_sec;
+  credit = 0;
+  fast_forward = skipping = false;
+}
+
+void Event_Player_Fast_Forward(bool on) {
+  fast_forward = on;
+}
+
+/**
+ * @brief Play everything pending, and everything pushed from now on, at the
+ * next tick, until the rate is set again.
+ * */
+void Event_Player_Skip(void) {
+  skipping = true;
+}
+
+/**
+ * @brief Play this frame's share of pending events. Call once a frame.
+ * @return number of events played.
+ * */
+u32 Event_Player_Tick(void) {
+  u32 played = 0;
+  if (!ring)
+    return 0;
+  if (skipping) {
+    while (ring_ct) {
+      Event_Log_Play_Oldest(false);
+      ++played;
+    }
+    return played;
+  }
+  credit += fast_forward ? rate<<EVENT_FF_SHIFT : rate;
+  while (ring_ct && credit >= EVENT_TICK_RATE) {
+    credit -= EVENT_TICK_RATE;
+    Event_Log_Play_Oldest(false);
+    ++played;
+  }
+  // Don't bank time spent waiting on the algorithm
+  if (!ring_ct)
+    credit = 0;
+  return played;
+}
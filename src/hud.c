@@ -0,0 +1,177 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_def.h"
+#include "gba_dma.h"
+#include "gba_mmap.h"
+#include "gba_types.h"
+#include "hud.h"
+#include "maze_render.h"
+#include "subpixel.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DCNT_BG1 0x0200
+#define BG_CNT_8BPP 0x0080
+// Tile 0 is left clear for the map outside the HUD; glyph pairs start at 1
+#define HUD_TILE(row, col) (1 + (row)*(HUD_COLS/2) + ((col)>>1))
+
+typedef u32 HudGlyph_t[SubPixel_Glyph_Height];
+
+// Glyph idx, one word of 8bpp palette indices per row
+static HudGlyph_t *glyphs = NULL;
+// What's on screen now, and what Hud_Printf has asked for since, so flushing
+// only touches what changed
+static char shown[HUD_ROWS][HUD_COLS], pending[HUD_ROWS][HUD_COLS];
+// Bit per row printed since the last flush
+static u32 rows_printed = 0;
+static bool visible = false;
+
+/**
+ * @brief Give each of the glyph colors (0 being the HUD's background) a BG
+ * palette entry the tiled renderer doesn't use: it takes entries 1 and 2 of
+ * every bank, and 0 is the backdrop.
+ * */
+static void Hud_Palette_Init(u8 pal_idx[15]) {
+  int idx = 3;
+  for (int i = 0; i < 15; ++i, ++idx) {
+    if ((idx&15) < 3)
+      idx = (idx&~15) + 3;
+    pal_idx[i] = idx;
+    PAL_BG_MEM[idx] = i ? SubPixel_Pal[i] : HUD_BG_COLOR;
+  }
+}
+
+static void Hud_Glyph_Expand(HudGlyph_t rows, int idx, const u8 pal_idx[15]) {
+  const u16 *data = &SubPixel_Glyph_Data[idx*SubPixel_Glyph_Height];
+  for (int i = 0; i < SubPixel_Glyph_Height; ++i) {
+    const SubPixel_Pair_t *pairs = (const SubPixel_Pair_t*)(data + i);
+    rows[i] = pal_idx[pairs[0].l] | (pal_idx[pairs[0].r]<<8)
+      | (pal_idx[pairs[1].l]<<16) | ((u32)pal_idx[pairs[1].r]<<24);
+  }
+}
+
+/**
+ * @brief Set the HUD up on BG1, blank and hidden. Call after the tiled
+ * renderer's Maze_Renderer_Use, since it claims its VRAM and palette around
+ * what that sets up.
+ * @return false if the tiled renderer isn't the one in use, or allocation
+ * fails.
+ * */
+bool Hud_Init(void) {
+  u8 pal_idx[15];
+  Hud_Close();
+  if (MAZE_RENDERER!=&MAZE_RENDERER_TILED)
+    return false;
+  if (!(glyphs = malloc(SubPixel_Glyph_Count*sizeof(HudGlyph_t))))
+    return false;
+  Hud_Palette_Init(pal_idx);
+  for (int i = 0; i < SubPixel_Glyph_Count; ++i)
+    Hud_Glyph_Expand(glyphs[i], i, pal_idx);
+
+  Tile8 *tiles = TILE8_MEM[HUD_CBB];
+  DMA3_Fill32(tiles[0], 0, sizeof(Tile8)/4);
+  DMA3_Fill32(tiles[1], 0x01010101U*pal_idx[0], HUD_ROWS*(HUD_COLS/2)*sizeof(Tile8)/4);
+  DMA3_Fill32(SE_MEM[HUD_SBB], 0, sizeof(Screenblock)/4);
+  for (int row = 0; row < HUD_ROWS; ++row) {
+    for (int col = 0; col < HUD_COLS; col += 2)
+      SE_MEM[HUD_SBB][(row<<5) + (col>>1)] = HUD_TILE(row, col);
+  }
+  for (int row = 0; row < HUD_ROWS; ++row) {
+    for (int col = 0; col < HUD_COLS; ++col)
+      shown[row][col] = pending[row][col] = ' ';
+  }
+  rows_printed = 0;
+  REG_BG_CNT(1) = (HUD_CBB<<2) | BG_CNT_8BPP | (HUD_SBB<<8);
+  REG_BG_HOFS(1) = 0;
+  REG_BG_VOFS(1) = 0;
+  return true;
+}
+
+void Hud_Close(void) {
+  Hud_Show(false);
+  free(glyphs);
+  glyphs = NULL;
+}
+
+/**
+ * @return false if there's no HUD to show, i.e. Hud_Init hasn't succeeded.
+ * */
+bool Hud_Show(bool show) {
+  visible = show && glyphs;
+  if (visible)
+    REG_DISPLAY_CNT |= DCNT_BG1;
+  else
+    REG_DISPLAY_CNT &= ~DCNT_BG1;
+  return visible==show;
+}
+
+/**
+ * @return whether the HUD is showing now.
+ * */
+bool Hud_Toggle(void) {
+  Hud_Show(!visible);
+  return visible;
+}
+
+bool Hud_Visible(void) {
+  return visible;
+}
+
+/**
+ * @brief printf onto HUD line row, padded with spaces (and cut) to the full
+ * width. Characters without a glyph print as spaces. Nothing reaches VRAM
+ * until the next Hud_Flush, so this is safe to call mid-frame.
+ * @return as vsnprintf, or -1 if the HUD isn't set up or row is out of range.
+ * */
+int Hud_Printf(int row, const char *fmt, ...) {
+  char line[HUD_COLS+1];
+  va_list args;
+  int ret;
+  if (!glyphs || row < 0 || row >= HUD_ROWS)
+    return -1;
+  va_start(args, fmt);
+  ret = vsnprintf(line, sizeof(line), fmt, args);
+  va_end(args);
+  if (ret < 0)
+    return ret;
+  char *next = pending[row];
+  bool ended = false;
+  for (int col = 0; col < HUD_COLS; ++col) {
+    int c = ' ';
+    if (!ended && !(ended = !line[col]))
+      c = line[col];
+    if (c < ' ' || c - ' ' >= SubPixel_Glyph_Count)
+      c = ' ';
+    next[col] = c;
+  }
+  rows_printed |= 1<<row;
+  return ret;
+}
+
+/**
+ * @brief Write the glyphs that changed since the last flush into the HUD's
+ * tiles. Call during VBlank, so the HUD never tears.
+ * */
+void Hud_Flush(void) {
+  Tile8 *tiles = TILE8_MEM[HUD_CBB];
+  if (!glyphs)
+    return;
+  for (int row = 0; rows_printed; ++row, rows_printed >>= 1) {
+    if (!(rows_printed&1))
+      continue;
+    char *prev = shown[row];
+    const char *next = pending[row];
+    for (int col = 0; col < HUD_COLS; ++col) {
+      if (prev[col]==next[col])
+        continue;
+      prev[col] = next[col];
+      const u32 *src = glyphs[next[col] - ' '];
+      u32 *dst = tiles[HUD_TILE(row, col)] + (col&1);
+      for (int i = 0; i < SubPixel_Glyph_Height; ++i, dst += 2)
+        *dst = src[i];
+    }
+  }
+}
@@ -3,7 +3,11 @@
 |******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
 \******************************************************************************/
 #include "bstree.h"
+#include "cycle_timer.h"
+#include "dirty_cells.h"
+#include "event_log.h"
 #include "graph.h"
+#include "hud.h"
 #include "gba_def.h"
 #include "gba_util_macros.h"
 #include "input.h"
@@ -11,7 +15,14 @@
 #include "gba_types.h"
 #include "gba_funcs.h"
 #include "gba_mmap.h"
+#include "maze.h"
+#include "maze_render.h"
+#include "maze_walls.h"
+#include "maze_save.h"
 #include "mode3_io.h"
+#include "rng.h"
+#include "scheduler.h"
+#include "sprite_overlay.h"
 
 #ifdef _DEBUG_LOG_TO_SAVEFILE_
 #include "sav_debug_log.h"
@@ -19,27 +30,7 @@
 
 #include <stdlib.h>
 #include <assert.h>
-
-typedef enum e_direction {
-  NONE_OR_START=0,
-  LEFT=1,
-  RIGHT=2,
-  UP=4,
-  DOWN=8,
-  HORIZONTAL_MASK=3,
-  VERTICAL_MASK=12
-} __attribute__ ((packed)) Direction_e;
-
-typedef enum e_maze_field {
-  MF_LEFT_WALL=1,
-  MF_RIGHT_WALL=2,
-  MF_TOP_WALL=4,
-  MF_BTM_WALL=8,
-  MF_LR_WALLS=3,
-  MF_TB_WALLS=12,
-  MF_INITIALIZED=128
-} __attribute__ ((packed)) MazeField_e;
-#define COORD(_x,_y) (Coord_t){.x=_x, .y=_y}
+#include <malloc.h>
 
 extern int get_unclosed_block_ct(void);
   
@@ -56,14 +47,29 @@ LL_DECL(Mvmt_t, Mvmt);
 
 #define Mvmt_LL_Dequeue(ll, dst) Mvmt_LL_Pop(ll, dst)
 #define MSTACK_PEAK(ll) (ll->head->data)
-#ifndef GRID_WIDTH
-#define GRID_WIDTH 80
-#endif  /* ! defined(GRID_WIDTH) */
-#ifndef GRID_HEIGHT
-#define GRID_HEIGHT 40
-#endif  /* ! defined(GRID_HEIGHT) */
-
-u8 GRID[GRID_HEIGHT][GRID_WIDTH];
+#ifndef MAZE_GENERATOR
+#define MAZE_GENERATOR MG_WILSON
+#endif  /* ! defined(MAZE_GENERATOR) */
+
+#if !defined(GRID_WIDTH) || !defined(GRID_HEIGHT)
+// Sizes offered at startup. Each divides the screen evenly so there's no dead
+// border. Building with GRID_WIDTH and GRID_HEIGHT both defined skips the menu.
+static const Coord_t MAZE_SIZE_PRESETS[] = {
+  {.x=24, .y=16},
+  {.x=40, .y=32},
+  {.x=60, .y=40},
+  {.x=80, .y=40},
+  {.x=120, .y=80},
+};
+#define MAZE_SIZE_PRESET_CT (int)(sizeof(MAZE_SIZE_PRESETS)/sizeof(Coord_t))
+#define MAZE_SIZE_PRESET_DEFAULT 3
+#endif  /* ! (defined(GRID_WIDTH) && defined(GRID_HEIGHT)) */
+
+#ifndef MAZE_MIN_BITMAP_CELL_PX
+// Smaller cells than this and the maze goes in the scrolling tiled viewport
+// instead of being squeezed onto one screen
+#define MAZE_MIN_BITMAP_CELL_PX 4
+#endif
 
 void BinaryTree_Inorder(BinaryTree_t *tree, void (*traversal_callback)(const void*)) {
   BinaryTreeNode_t *node, **stack;
@@ -171,12 +177,55 @@ STAT_INLN Mvmt_t Mvmt_LL_Peak(Mvmt_LL_t *mll) {
   return mll->head->data;
 }
 
+/**
+ * @brief Fixed-capacity movement stack. Only the direction of each move is
+ * stored; the destination of the top move is kept in head, and popping walks
+ * head back by the popped direction. The buffer is allocated once, sized to
+ * the grid's cell count, so push/pop never touch the heap.
+ * */
+typedef struct s_mvmt_stack {
+  Direction_e *dirs;
+  Coord_t head;
+  size_t nmemb, cap;
+} Mvmt_Stack_t;
+
+/**
+ * @brief Random walk state for Wilson's algorithm.
+ * path_stamps is a grid-sized array keyed by cell index. A cell is on the
+ * current walk's path iff its stamp equals path_stamp, so bumping path_stamp
+ * empties the set without touching the array.
+ * unvisited holds every cell not yet in the maze, packed as x | y<<8, in no
+ * particular order, and unvisited_pos maps a cell index back to its slot so
+ * that cells can be swap-removed in O(1) as they get incorporated. Packed
+ * coordinates come back out with a mask and a shift, where a cell index would
+ * take a division by the grid width.
+ * */
+#define WALK_PACK(c) ((u16)((c).x | ((c).y<<8)))
+#define WALK_UNPACK(packed) COORD((packed)&0xFF, (packed)>>8)
+
 typedef struct s_walk {
   Coord_t start;
-  Mvmt_LL_t path;
-  BinaryTree_t *path_coord_set;
+  Mvmt_Stack_t path;
+  u16 *path_stamps, *unvisited;
+  u32 *unvisited_pos;
+  u32 cell_ct, unvisited_ct;
+  u16 path_stamp;
 } Walk_t;
 
+typedef struct s_wilson_stats {
+  /* Walks started, and the number of cells already in the maze at each start,
+   * summed. A rejection loop drawing random cells would throw away
+   * visited/unvisited draws per start, so start_visited_sum/walk_starts
+   * against the grid size tells how much picking from the unvisited index
+   * saves. Kept as sums so that nothing here divides. */
+  u32 walk_starts, start_visited_sum;
+  /* Random-walk steps attempted by the Aldous-Broder phase of
+   * Wilsons_Hybrid_Algo and by the loop-erased walks, respectively. */
+  u32 ab_steps, wilson_steps;
+} Wilson_Stats_t;
+
+Wilson_Stats_t WILSON_STATS = {0};
+
 STAT_INLN int Coord_Cmp(Coord_t a, Coord_t b) {
   if (a.y!=b.y)
     return a.y-b.y;
@@ -192,20 +241,89 @@ static int coord_bst_cmpcb(const void *a, const void *b) {
   return Coord_Cmp(*(const Coord_t*)a, *(const Coord_t*)b);
 }
 
-void Walk_Init(Walk_t *walk, Coord_t start_coord) {
+STAT_INLN bool Walk_Path_Contains(const Walk_t *walk, Coord_t coord, int grid_width) {
+  return walk->path_stamps[CIDX(coord, grid_width)]==walk->path_stamp;
+}
+
+STAT_INLN void Walk_Path_Insert(Walk_t *walk, Coord_t coord, int grid_width) {
+  walk->path_stamps[CIDX(coord, grid_width)] = walk->path_stamp;
+}
+
+STAT_INLN void Walk_Path_Remove(Walk_t *walk, Coord_t coord, int grid_width) {
+  // Stamp 0 is never handed out as a walk's generation, so it reads as absent
+  walk->path_stamps[CIDX(coord, grid_width)] = 0;
+}
+
+void Walk_Free_Buffers(Walk_t *walk) {
+  free(walk->path_stamps);
+  free(walk->path.dirs);
+  free(walk->unvisited);
+  free(walk->unvisited_pos);
+  walk->path_stamps = NULL;
+  walk->path.dirs = NULL;
+  walk->unvisited = NULL;
+  walk->unvisited_pos = NULL;
+  walk->path.cap = walk->path.nmemb = 0UL;
+  walk->cell_ct = walk->unvisited_ct = 0UL;
+}
+
+bool Walk_Alloc_Buffers(Walk_t *walk, int grid_width, int grid_height) {
+  const u32 cell_ct = grid_width*grid_height;
+  u32 i = 0;
+  walk->path_stamps = calloc(cell_ct, sizeof(u16));
+  walk->path.dirs = malloc(cell_ct*sizeof(Direction_e));
+  walk->unvisited = malloc(cell_ct*sizeof(u16));
+  walk->unvisited_pos = malloc(cell_ct*sizeof(u32));
+  if (!walk->path_stamps || !walk->path.dirs || !walk->unvisited || !walk->unvisited_pos) {
+    Walk_Free_Buffers(walk);
+    return false;
+  }
+  for (int y = 0; y < grid_height; ++y) {
+    for (int x = 0; x < grid_width; ++x, ++i) {
+      walk->unvisited[i] = WALK_PACK(COORD(x, y));
+      walk->unvisited_pos[i] = i;
+    }
+  }
+  walk->unvisited_ct = cell_ct;
+  walk->path.cap = cell_ct;
+  walk->path.nmemb = 0UL;
+  walk->cell_ct = cell_ct;
+  walk->path_stamp = 0;
+  return true;
+}
+
+/**
+ * @brief Swap-remove cell c from the walk's unvisited index.
+ * */
+STAT_INLN void Walk_Mark_Visited(Walk_t *walk, Coord_t c, int grid_width) {
+  const u32 SLOT = walk->unvisited_pos[CIDX(c, grid_width)];
+  const u16 LAST = walk->unvisited[--(walk->unvisited_ct)];
+  const Coord_t LAST_C = WALK_UNPACK(LAST);
+  assert(SLOT <= walk->unvisited_ct && walk->unvisited[SLOT]==WALK_PACK(c));
+  walk->unvisited[SLOT] = LAST;
+  walk->unvisited_pos[CIDX(LAST_C, grid_width)] = SLOT;
+}
+
+void Walk_Init(Walk_t *walk, Coord_t start_coord, int grid_width) {
   walk->start = start_coord;
-  walk->path = LL_INIT(Mvmt);
-  walk->path_coord_set = BinaryTree_Create(malloc, free, NULL, NULL, coord_bst_cmpcb, sizeof(Coord_t), NULL);
+  walk->path.head = start_coord;
+  walk->path.nmemb = 0UL;
+  if (!++walk->path_stamp) {
+    // Generation counter wrapped. Clear stale stamps once every 65535 walks
+    fast_memset32(walk->path_stamps, 0, (walk->cell_ct*sizeof(u16))>>2);
+    if (walk->cell_ct&1)
+      walk->path_stamps[walk->cell_ct-1] = 0;
+    walk->path_stamp = 1;
+  }
 #ifdef _DEBUG_LOG_TO_SAVEFILE_
   debug_log_printf("Starting new random walk at init position (%d, %d)\n", start_coord.x, start_coord.y);
 #endif
-  assert(BinaryTree_Insert(walk->path_coord_set, &start_coord));
+  Walk_Path_Insert(walk, start_coord, grid_width);
 }
 
 void Walk_Close(Walk_t *walk) {
   walk->start = (Coord_t){.x=-1,.y=-1};
-  Mvmt_LL_Close(&(walk->path));
-  BinaryTree_Destroy(walk->path_coord_set); 
+  walk->path.nmemb = 0UL;
 }
 
 STAT_INLN Coord_t coords_sum(Coord_t a, Coord_t b) {
@@ -236,211 +354,143 @@ Coord_t dir_to_coord(Direction_e dir) {
 }
 
 
-#ifdef _DEBUG_LOG_TO_SAVEFILE_
-void debug_print__coordtree_traversal_cb(const void *data) {
-  Coord_t coord = *(const Coord_t*)data;
-  debug_log_printf("Tree Entry: (%d, %d)\n", coord.x, coord.y);
+STAT_INLN bool Mvmt_Stack_Push(Mvmt_Stack_t *stack, const Mvmt_t *mvmt) {
+  if (stack->nmemb >= stack->cap)
+    return false;
+  stack->dirs[stack->nmemb++] = mvmt->direction;
+  stack->head = mvmt->dest;
+  return true;
 }
-#endif  /* DEBUG LOGS TO .SAV FILE */
-#define _DRAW_WALK_  // TODO: DELETE THIS MACRO DEFINE
-bool Walk_Advance(Walk_t *walk, Direction_e dir, int grid_width, int grid_height) {
-#ifdef _DRAW_WALK_
-  BMP_Rect_t r = {
-    .x = 0, .y = 0,
-    .width = SCREEN_WIDTH/grid_width, .height = SCREEN_HEIGHT/grid_height, 
-    .color = 0
-  };
-#endif
+
+STAT_INLN bool Mvmt_Stack_Pop(Mvmt_Stack_t *stack, Mvmt_t *dest) {
+  if (!(stack->nmemb))
+    return false;
+  Direction_e dir = stack->dirs[--(stack->nmemb)];
+  if (dest)
+    *dest = (Mvmt_t){.dest=stack->head, .direction=dir};
+  stack->head = coords_diff(stack->head, dir_to_coord(dir));
+  return true;
+}
+
+STAT_INLN Mvmt_t Mvmt_Stack_Peak(const Mvmt_Stack_t *stack) {
+  if (!(stack->nmemb))
+    return NO_MVMT;
+  return (Mvmt_t){.dest=stack->head, .direction=stack->dirs[stack->nmemb-1]};
+}
+
+bool Walk_Advance(Walk_t *walk, Direction_e dir, const Maze_t *maze) {
+  const int grid_width = maze->width, grid_height = maze->height;
   Mvmt_t head, newhead={EMPTY_COORD, NONE_OR_START};
-  Mvmt_LL_t *path = &(walk->path);
+  Mvmt_Stack_t *path = &(walk->path);
   if (!walk) return false;
   if (path->nmemb==0) {
+    // Nothing to backtrack onto from the start cell, so any direction goes
     head = (Mvmt_t){.dest=walk->start, .direction=NONE_OR_START};
-    Direction_e dirmask=head.direction;
-    if (dirmask&HORIZONTAL_MASK) {
-      dirmask = HORIZONTAL_MASK;
-    } else {
-      dirmask = VERTICAL_MASK;
-    }
-
-    if (dir&dirmask) {
-      if (head.direction!=dir) {
-        // if this is the case, then direction is opposite to last movement, 
-        // thus leading back to coord of previous position (aka second-to-top
-        // of stack)
-        return false;
-      }
-    }
   } else {
-    head = Mvmt_LL_Peak(path);
+    head = Mvmt_Stack_Peak(path);
   }
 
   Coord_t dst = coords_sum(head.dest, dir_to_coord(dir));
   if (!valid_grid_coord(dst, grid_width, grid_height))
     return false;
-  if (BinaryTree_Contains(walk->path_coord_set, &dst)) {
+  if (Walk_Path_Contains(walk, dst, grid_width)) {
 #ifdef _DEBUG_LOG_TO_SAVEFILE_
-  debug_log_printf("Tree contains: (%d, %d)\n", dst.x, dst.y);
-  debug_log_printf("Tree element ct: %u\n", BinaryTree_Element_Count(walk->path_coord_set));
-  debug_log_printf("Path LL element ct: %u\n", path->nmemb);
-    BinaryTree_Inorder(walk->path_coord_set, debug_print__coordtree_traversal_cb);
+  debug_log_printf("Path contains: (%d, %d)\n", dst.x, dst.y);
+  debug_log_printf("Path stack element ct: %u\n", path->nmemb);
     {
-      Coord_t c;
-      int idx = 0;
-      LL_FOREACH(LL_NODE_VAR_INITIALIZER(Mvmt, cur), cur, path) {
-        c = cur->data.dest;
-        debug_log_printf("path[%d] = (%d, %d)\n", idx++, c.x, c.y);
+      Coord_t c = path->head;
+      for (size_t idx = path->nmemb; idx--;) {
+        debug_log_printf("path[%u] = (%d, %d)\n", idx, c.x, c.y);
+        c = coords_diff(c, dir_to_coord(path->dirs[idx]));
       }
     }
 #endif  /* DEBUG LOGS TO .SAV FILE */
     while (path->nmemb!=0UL) {
-      head = Mvmt_LL_Peak(path);
+      head = Mvmt_Stack_Peak(path);
       if (coords_eq(head.dest, dst))
         break;
-      Mvmt_LL_Pop(path, &head);
-      assert(BinaryTree_Remove(walk->path_coord_set, &head.dest));
-#ifdef _DRAW_WALK_
-      r.x = head.dest.x*r.width;
-      r.y = head.dest.y*r.height;
-      r.color = 0;
-      mode3_draw_rect(&r);
-#endif
+      Mvmt_Stack_Pop(path, &head);
+      assert(Walk_Path_Contains(walk, head.dest, grid_width));
+      Walk_Path_Remove(walk, head.dest, grid_width);
+      MAZE_OBSERVE(maze, walk, head.dest, MWM_OFF);
     }
     assert((path->nmemb!=0UL) || 
-        (BinaryTree_Element_Count(walk->path_coord_set)==1 &&
-          coords_eq(walk->start, dst) &&
-          BinaryTree_Contains(walk->path_coord_set, &dst)));
+        (coords_eq(walk->start, dst) &&
+          Walk_Path_Contains(walk, dst, grid_width)));
     return false;
   }
-  BinaryTree_Insert(walk->path_coord_set, &dst);
+  Walk_Path_Insert(walk, dst, grid_width);
   newhead.dest = dst;
   newhead.direction = dir;
-  Mvmt_LL_Push(path, &newhead);
-#ifdef _DRAW_WALK_
-  r.x = newhead.dest.x*r.width;
-  r.y = newhead.dest.y*r.height;
-  r.color = 0x7A08;
-  mode3_draw_rect(&r);
-#endif
+  assert(Mvmt_Stack_Push(path, &newhead));
+  MAZE_OBSERVE(maze, walk, newhead.dest, MWM_ON);
   return true;
 }
 
-STAT_INLN Coord_t randcoord(int grid_width, int grid_height) {
-  return COORD(rand()%grid_width, rand()%grid_height);
+STAT_INLN Coord_t randcoord(const Maze_t *maze) {
+  return COORD(Rng_Range(&MAZE_RNG, maze->width), Rng_Range(&MAZE_RNG, maze->height));
 }
 
 STAT_INLN Direction_e randdir(void) {
-  u32 r = rand();
-  if (r&2) {
-    return r&1 ? RIGHT : LEFT;
-  } else if (r&1) {
-    return DOWN;
-  } else {
-    return UP;
-  }
+  return Rng_Dir(&MAZE_RNG);
 }
 
-#define CIDX(coord, gwidth) (coord.x + coord.y*gwidth)
-
-void Walk(Walk_t *walk, const u8 *grid, int grid_width, int grid_height) {
-  if (!walk || !grid) return;
-  if (BinaryTree_Element_Count(walk->path_coord_set)!=0) {
+/**
+ * @brief Pick a random unvisited cell and start a fresh walk from it.
+ * */
+void Walk_Begin(Walk_t *walk, const Maze_t *maze) {
+  const int grid_width = maze->width;
+  if (walk->path.nmemb!=0) {
     Walk_Close(walk);
   }
 
   Coord_t start;
-  do {
-    start = randcoord(grid_width, grid_height);
-  } while ((grid[CIDX(start, grid_width)] & MF_INITIALIZED));
-#ifdef _DRAW_WALK_
-  BMP_Rect_t r = {.width = SCREEN_WIDTH/grid_width, .height=SCREEN_HEIGHT/grid_height, .x=0,.y=0,.color = 0x7FFF};
-  r.x = start.x*r.width;
-  r.y = start.y*r.height;
-  mode3_draw_rect(&r);
-#endif
+  assert(walk->unvisited_ct!=0);
+  const u16 CELL = walk->unvisited[Rng_Range(&MAZE_RNG, walk->unvisited_ct)];
+  start = WALK_UNPACK(CELL);
+  ++WILSON_STATS.walk_starts;
+  WILSON_STATS.start_visited_sum += walk->cell_ct - walk->unvisited_ct;
+  assert(!(maze->grid[CIDX(start, grid_width)] & MF_INITIALIZED));
+  MAZE_OBSERVE(maze, walk, start, MWM_START);
+
+  Walk_Init(walk, start, grid_width);
+}
 
-  Walk_Init(walk, start);
+/**
+ * @brief Take one random step of the walk.
+ * @return true once the walk has reached a cell already in the maze.
+ * */
+bool Walk_Step(Walk_t *walk, const Maze_t *maze) {
   Mvmt_t head;
-  bool advanced;
-  for (;;) {
-    do {
-      advanced = Walk_Advance(walk, randdir(), grid_width, grid_height);
-//      vsync();
-    } while (!advanced);
-    if (walk->path.nmemb==0)
-      continue;
-    head = Mvmt_LL_Peak(&(walk->path));
-    if (grid[CIDX(head.dest, grid_width)] & MF_INITIALIZED)
-      return;
-  }
+  bool advanced = Walk_Advance(walk, randdir(), maze);
+  ++WILSON_STATS.wilson_steps;
+  if (!advanced || walk->path.nmemb==0)
+    return false;
+  head = Mvmt_Stack_Peak(&(walk->path));
+  return maze->grid[CIDX(head.dest, maze->width)] & MF_INITIALIZED;
 }
 
-void mode3_draw_line(Coord_t start, u32 color, int length, bool vertical) {
-  if (!valid_grid_coord(start, SCREEN_WIDTH, SCREEN_HEIGHT)) return;
-  if (length <= 0) return;
-
-  u16 *vr = VRAM_BUF + start.x + start.y*SCREEN_WIDTH;
-  if (vertical) {
-    if (start.y + length > SCREEN_HEIGHT)
-      return;
-    do {
-      *vr = color;
-      vr+= SCREEN_WIDTH;
-    } while (--length);
-  } else {
-    if (start.x + length > SCREEN_WIDTH)
-      return;
-    do {
-      *vr++ = color;
-    } while (--length);
-  }
+void Walk(Walk_t *walk, const Maze_t *maze) {
+  if (!walk || !maze) return;
+  Walk_Begin(walk, maze);
+  while (!Walk_Step(walk, maze))
+    continue;
 }
 
-void draw_maze_cell(u8 *grid, const Coord_t *coord, int grid_width, int grid_height, u32 color) {
-  Coord_t c = *coord;
-  if (!valid_grid_coord(c, grid_width, grid_height))
-    return;
-  BMP_Rect_t r = {.x=0,.y=0,.width=SCREEN_WIDTH/grid_width, .height = SCREEN_HEIGHT/grid_height, .color = color};
-  r.x = c.x*r.width;
-  r.y = c.y*r.height;
-  u8 cell = grid[CIDX(c, grid_width)];
-  if (!(cell&MF_INITIALIZED)) {
-    r.color = 0;
-    mode3_draw_rect(&r);
-    return;
-  }
-  Coord_t rc = COORD(c.x*r.width, c.y*r.height);
-  mode3_draw_rect(&r);
-  if (cell&MF_LEFT_WALL) {
-    mode3_draw_line(rc, 0x10A5, r.height, true);
-  }
-  if (cell&MF_RIGHT_WALL) {
-    int orig = rc.x;
-    rc.x += r.width-1;
-    mode3_draw_line(rc, 0x10A5, r.height, true);
-    rc.x = orig;
-  }
-
-  if (cell&MF_TOP_WALL) {
-    mode3_draw_line(rc, 0x10A5, r.width, false);
-  }
-
-  if (cell&MF_BTM_WALL) {
-    rc.y += r.height-1;
-    mode3_draw_line(rc, 0x10A5, r.width, false);
-  }
-}
 #define FORCE_ASSERTION_FAILURE false
 
 #define IDX(x,y,gw) (x+y*gw)
 
 
-
-void Incorporate_Walk(u8 *grid, Walk_t *walk, int grid_width) {
-  Mvmt_LL_t *path = &(walk->path);
+void Incorporate_Walk(Maze_t *maze, Walk_t *walk) {
+  u8 *grid = maze->grid;
+  const int grid_width = maze->width;
+  Mvmt_Stack_t *path = &(walk->path);
   Mvmt_t curmove;
-  assert(Mvmt_LL_Pop(path, &curmove));
+  Coord_t carved;
+  assert(Mvmt_Stack_Pop(path, &curmove));
   assert(grid[CIDX(curmove.dest, grid_width)]&MF_INITIALIZED);
+  carved = curmove.dest;
   switch (curmove.direction) {
   case NONE_OR_START:
     assert(FORCE_ASSERTION_FAILURE);
@@ -470,10 +520,15 @@ void Incorporate_Walk(u8 *grid, Walk_t *walk, int grid_width) {
     assert(curmove.direction!=HORIZONTAL_MASK && curmove.direction!=VERTICAL_MASK);
     break;
   }
+  // Each popped cell has now had both of its path walls carved, so it can be
+  // drawn in its final state straight away.
+  MAZE_OBSERVE(maze, carve, carved);
 
   while (path->nmemb) {
-    assert(Mvmt_LL_Pop(path, &curmove));
+    assert(Mvmt_Stack_Pop(path, &curmove));
     grid[CIDX(curmove.dest, grid_width)] |= MF_INITIALIZED;
+    Walk_Mark_Visited(walk, curmove.dest, grid_width);
+    carved = curmove.dest;
     switch (curmove.direction) {
     case NONE_OR_START:
       assert(curmove.direction!=NONE_OR_START);
@@ -503,17 +558,15 @@ void Incorporate_Walk(u8 *grid, Walk_t *walk, int grid_width) {
       assert(FORCE_ASSERTION_FAILURE);
       break;
     }
+    MAZE_OBSERVE(maze, carve, carved);
   }
-
+  grid[CIDX(walk->start, grid_width)] |= MF_INITIALIZED;
+  Walk_Mark_Visited(walk, walk->start, grid_width);
 }
 
-void walk_traversal_draw_callback_register_params(u8 *param_grid, int param_gwidth, int param_gheight);
-void walk_traversal_draw_cb(const void *userdata);
-
-void Wilsons_Algo(u8 *grid, int grid_width, int grid_height) {
-  const u32 GRID_CELL_TOTAL = grid_width*grid_height;
-  u32 initialized_ct=0UL;
-  walk_traversal_draw_callback_register_params(grid, grid_width, grid_height);
+void Grid_Reset(Maze_t *maze) {
+  u8 *grid = maze->grid;
+  const int grid_width = maze->width, grid_height = maze->height;
   fast_memset32(grid, 0x0F0F0F0F, grid_width*grid_height/4);
   {
     int remainder;
@@ -521,37 +574,243 @@ void Wilsons_Algo(u8 *grid, int grid_width, int grid_height) {
 
       u8 *rem = &grid[(grid_width*grid_height)&(~3)];
       while (remainder--) {
-        *rem++ = 0;
+        *rem++ = MF_LR_WALLS|MF_TB_WALLS;
       }
     }
   }
+}
 
-  Coord_t init = randcoord(grid_width, grid_height);
-  grid[CIDX(init, grid_width)] |= MF_INITIALIZED;
-  assert(++initialized_ct==1);
-#ifdef _DRAW_WALK_
-  draw_maze_cell(grid, &init, grid_width, grid_height, 0x7FFF);
-#endif
-  Walk_t walk={0};
-  do {
-    Walk(&walk, grid, grid_width, grid_height);
-    initialized_ct += walk.path.nmemb;
-    Incorporate_Walk(grid, &walk, grid_width);
-    BinaryTree_Inorder(walk.path_coord_set, walk_traversal_draw_cb);
-    
+/**
+ * @brief Allocate a width x height maze, grid and wall bitplanes included, off
+ * the heap (EWRAM). Only the memory for that size is committed, so mazes of
+ * any size up to MAZE_DIM_MAX a side can be made and freed at runtime.
+ * @return NULL if the size is out of range or allocation fails.
+ * */
+Maze_t *Maze_Create(int width, int height) {
+  Maze_t *maze;
+  if (width <= 0 || height <= 0 || width > MAZE_DIM_MAX || height > MAZE_DIM_MAX)
+    return NULL;
+  // Grid goes right after the struct, which keeps it word aligned for
+  // Grid_Reset's fast_memset32
+  if (!(maze = malloc(sizeof(Maze_t) + width*height)))
+    return NULL;
+  maze->grid = (u8*)(maze+1);
+  maze->width = width;
+  maze->height = height;
+  maze->seed = 0;
+  maze->gen_id = MG_MAX;
+  maze->observer = NULL;
+  if (!Maze_Walls_Init(&maze->walls, width, height)) {
+    free(maze);
+    return NULL;
+  }
+  Grid_Reset(maze);
+  return maze;
+}
+
+void Maze_Destroy(Maze_t *maze) {
+  if (!maze)
+    return;
+  Maze_Walls_Close(&maze->walls);
+  free(maze);
+}
+
+STAT_INLN void Grid_Carve(Maze_t *maze, Coord_t c, Direction_e dir) {
+  Grid_Carve_Idx(maze, CIDX(c, maze->width), dir);
+}
+
+static void Wilsons_Fill(Maze_t *maze, Walk_t *walk) {
+  while (walk->unvisited_ct) {
+    Walk(walk, maze);
+    Incorporate_Walk(maze, walk);
  
-    grid[CIDX(walk.start, grid_width)] |= MF_INITIALIZED;
-    draw_maze_cell(grid, &walk.start, grid_width, grid_height, 0x7FFF);
-/*    for (Coord_t c = COORD(0,0); c.y < grid_height; ++c.y) {
-      for (c.x = 0; c.x < grid_width; ++c.x) {
-        draw_maze_cell(grid, &c, grid_width, grid_height);
-      }
+    MAZE_OBSERVE(maze, carve, walk->start);
+    Walk_Close(walk);
+  }
+}
+
+/*
+ * Wilson's algorithm as a resumable task: each step is one random step of the
+ * current walk, or starting a walk, or carving a finished one in.
+ * */
+typedef struct s_wilson_task {
+  Maze_t *maze;
+  Walk_t walk;
+  bool walking;
+} WilsonTask_t;
+
+static bool Wilsons_Begin(WilsonTask_t *task, Maze_t *maze) {
+  Coord_t init;
+  Grid_Reset(maze);
+  WILSON_STATS = (Wilson_Stats_t){0};
+
+  *task = (WilsonTask_t){.maze = maze, .walking = false};
+  if (!Walk_Alloc_Buffers(&task->walk, maze->width, maze->height))
+    return false;
+  init = randcoord(maze);
+  maze->grid[CIDX(init, maze->width)] |= MF_INITIALIZED;
+  Walk_Mark_Visited(&task->walk, init, maze->width);
+  MAZE_OBSERVE(maze, carve, init);
+  return true;
+}
+
+static TaskStatus_e Wilsons_Step(void *state) {
+  WilsonTask_t *task = state;
+  Maze_t *maze = task->maze;
+  if (!task->walking) {
+    if (!task->walk.unvisited_ct) {
+      Walk_Free_Buffers(&task->walk);
+      return TASK_DONE;
     }
-*/
-    Walk_Close(&walk);
-  } while (initialized_ct < GRID_CELL_TOTAL);
+    Walk_Begin(&task->walk, maze);
+    task->walking = true;
+    return TASK_RUNNING;
+  }
+  if (!Walk_Step(&task->walk, maze))
+    return TASK_RUNNING;
+  Incorporate_Walk(maze, &task->walk);
+  MAZE_OBSERVE(maze, carve, task->walk.start);
+  Walk_Close(&task->walk);
+  task->walking = false;
+  return TASK_RUNNING;
+}
+
+bool Wilsons_Algo(Maze_t *maze) {
+  WilsonTask_t task;
+  if (!Wilsons_Begin(&task, maze))
+    return false;
+  while (Wilsons_Step(&task)==TASK_RUNNING)
+    continue;
+  return true;
+}
+
+/**
+ * @brief Aldous-Broder/Wilson hybrid. An Aldous-Broder random walk carves the
+ * maze until ab_percent percent of cells have been visited (cheap while most
+ * cells are new), then the remaining cells are added with Wilson's loop-erased
+ * walks (cheap once the maze is large enough to hit quickly). Both phases
+ * sample uniform spanning trees, so the result is still uniform.
+ * Step counts for each phase are left in WILSON_STATS.
+ * @return false if allocation fails.
+ * */
+bool Wilsons_Hybrid_Algo(Maze_t *maze, u32 ab_percent) {
+  u8 *grid = maze->grid;
+  const int grid_width = maze->width, grid_height = maze->height;
+  const u32 GRID_CELL_TOTAL = grid_width*grid_height;
+  u32 ab_target;
+  Coord_t c, step;
+  Direction_e dir;
+  Grid_Reset(maze);
+  WILSON_STATS = (Wilson_Stats_t){0};
+  if (ab_percent > 100)
+    ab_percent = 100;
+  ab_target = (GRID_CELL_TOTAL*ab_percent)/100;
+
+  Walk_t walk={0};
+  if (!Walk_Alloc_Buffers(&walk, grid_width, grid_height))
+    return false;
+  c = randcoord(maze);
+  grid[CIDX(c, grid_width)] |= MF_INITIALIZED;
+  Walk_Mark_Visited(&walk, c, grid_width);
+  MAZE_OBSERVE(maze, carve, c);
+
+  while (GRID_CELL_TOTAL - walk.unvisited_ct < ab_target) {
+    dir = randdir();
+    step = coords_sum(c, dir_to_coord(dir));
+    ++WILSON_STATS.ab_steps;
+    if (!valid_grid_coord(step, grid_width, grid_height))
+      continue;
+    if (!(grid[CIDX(step, grid_width)]&MF_INITIALIZED)) {
+      Grid_Carve(maze, c, dir);
+      grid[CIDX(step, grid_width)] |= MF_INITIALIZED;
+      Walk_Mark_Visited(&walk, step, grid_width);
+      MAZE_OBSERVE(maze, carve, c);
+      MAZE_OBSERVE(maze, carve, step);
+    }
+    c = step;
+  }
+
+  Wilsons_Fill(maze, &walk);
+  Walk_Free_Buffers(&walk);
+  return true;
+}
+
+
+STAT_INLN u8 dir_to_exit_arrow(Direction_e dir) {
+  switch (dir) {
+  case LEFT:
+    return 1<<MF_EXIT_ARROW_SHIFT;
+  case RIGHT:
+    return 2<<MF_EXIT_ARROW_SHIFT;
+  case UP:
+    return 3<<MF_EXIT_ARROW_SHIFT;
+  case DOWN:
+    return 4<<MF_EXIT_ARROW_SHIFT;
+  default:
+    return 0;
+  }
 }
 
+STAT_INLN Direction_e exit_arrow_to_dir(u8 cell) {
+  static const Direction_e ARROW_DIRS[8] = {
+    NONE_OR_START, LEFT, RIGHT, UP, DOWN, NONE_OR_START, NONE_OR_START, NONE_OR_START
+  };
+  return ARROW_DIRS[(cell&MF_EXIT_ARROW)>>MF_EXIT_ARROW_SHIFT];
+}
+
+/**
+ * @brief Wilson's algorithm in the "last exit direction" formulation.
+ * Rather than keeping an explicit path and erasing loops, each unvisited cell
+ * the walk passes through records (in its MF_EXIT_ARROW bits) the direction
+ * the walk last left it by. Revisiting a cell just overwrites its arrow, which
+ * erases the loop implicitly. Once the walk hits the maze, following the
+ * arrows from the start cell yields the loop-erased path, which gets carved.
+ * Needs no memory beyond the grid itself, so it never fails.
+ * */
+bool Wilsons_Algo_Exit_Arrows(Maze_t *maze) {
+  u8 *grid = maze->grid;
+  const int grid_width = maze->width, grid_height = maze->height;
+  Coord_t c, start, step;
+  Direction_e dir;
+  u8 *cell;
+  Grid_Reset(maze);
+
+  c = randcoord(maze);
+  grid[CIDX(c, grid_width)] |= MF_INITIALIZED;
+  MAZE_OBSERVE(maze, carve, c);
+
+  // Wilson's algorithm yields a uniform spanning tree regardless of the order
+  // walk start cells are picked in, so just sweep the grid.
+  for (start.y = 0; start.y < grid_height; ++start.y) {
+    for (start.x = 0; start.x < grid_width; ++start.x) {
+      if (grid[CIDX(start, grid_width)]&MF_INITIALIZED)
+        continue;
+      c = start;
+      while (!(*(cell=&grid[CIDX(c, grid_width)])&MF_INITIALIZED)) {
+        do {
+          dir = randdir();
+          step = coords_sum(c, dir_to_coord(dir));
+        } while (!valid_grid_coord(step, grid_width, grid_height));
+        *cell = (*cell&~MF_EXIT_ARROW) | dir_to_exit_arrow(dir);
+        c = step;
+      }
+
+      c = start;
+      while (!(*(cell=&grid[CIDX(c, grid_width)])&MF_INITIALIZED)) {
+        dir = exit_arrow_to_dir(*cell);
+        assert(dir!=NONE_OR_START);
+        *cell = (*cell&~MF_EXIT_ARROW) | MF_INITIALIZED;
+        Grid_Carve(maze, c, dir);
+        MAZE_OBSERVE(maze, carve, c);
+        step = coords_sum(c, dir_to_coord(dir));
+        c = step;
+      }
+      // c is the maze cell the walk joined at; one of its walls just opened
+      MAZE_OBSERVE(maze, carve, c);
+    }
+  }
+  return true;
+}
 
 int vicmp(const void *a, const void *b) {
   return (int)(((uintptr_t)a)-((uintptr_t)b));
@@ -561,11 +820,10 @@ int vicmp(const void *a, const void *b) {
 
 typedef Coord_t Vec2;
 
-STAT_INLN bool Valid_Mvmt(u8 *grid, const Coord_t *origin, const Mvmt_t *move, 
-    const Vec2 *grid_dims) {
+STAT_INLN bool Valid_Mvmt(const MazeWalls_t *walls, const Coord_t *origin, const Mvmt_t *move) {
   // for sake of inline brevity, skipping params' validity check
   Coord_t coord = coords_sum(*origin, move->dest);
-  if (!valid_grid_coord(coord, grid_dims->x, grid_dims->y))
+  if (!valid_grid_coord(coord, walls->width, walls->height))
     return false;
   coord = *origin;
   switch (move->direction) {
@@ -576,63 +834,129 @@ STAT_INLN bool Valid_Mvmt(u8 *grid, const Coord_t *origin, const Mvmt_t *move,
   case HORIZONTAL_MASK:
     return false;
   default:
-    return !(grid[CIDX(coord, grid_dims->x)]&(move->direction));
+    return !Maze_Walls_Blocked(walls, coord.x, coord.y, move->direction);
   }
 
 }
 
 
-Graph_t *Graph_Maze(u8 *grid, const Coord_t *start, const Coord_t *end, const Vec2 *grid_dims) {
-  if (!grid || !start || !end || !grid_dims)
-    return NULL;
-  Coord_t startpt = *start, endpt = *end, curr_coord, move_coord;
-  Graph_t *ret =  NULL;
-  int grid_width = grid_dims->x, grid_height = grid_dims->y;
-  ret = Graph_Init(NULL, NULL, coord_bst_cmpcb, sizeof(Coord_t));
+/*
+ * Graph_Maze as a resumable task: each step expands one vertex.
+ * */
+typedef struct s_graph_maze_task {
+  const Maze_t *maze;
+  Graph_t *graph;
+  size_t curr_idx;
+  // Two-way edges added so far
+  u32 edge_ct;
+} GraphMazeTask_t;
+
+static bool Graph_Maze_Begin(GraphMazeTask_t *task, const Maze_t *maze, const Coord_t *start, const Coord_t *end) {
+  if (!maze || !start || !end)
+    return false;
+  Coord_t startpt = *start, endpt = *end;
+  Graph_t *ret = Graph_Init(NULL, NULL, coord_bst_cmpcb, sizeof(Coord_t));
+  if (!ret)
+    return false;
   
   assert(Graph_Add_Vertex(ret, &startpt));
 
-  draw_maze_cell(grid, &startpt, grid_width, grid_height, 0x7A08);
+  MAZE_OBSERVE(maze, vertex, startpt);
   assert(Graph_Add_Vertex(ret, &endpt));
 
-  draw_maze_cell(grid, &endpt, grid_width, grid_height, 0x7A08);
+  MAZE_OBSERVE(maze, vertex, endpt);
+  *task = (GraphMazeTask_t){.maze = maze, .graph = ret, .curr_idx = 0, .edge_ct = 0};
+  return true;
+}
+
+static TaskStatus_e Graph_Maze_Step(void *state) {
+  GraphMazeTask_t *task = state;
+  const MazeWalls_t *walls = &task->maze->walls;
+  Graph_t *ret = task->graph;
+  const size_t curr_idx = task->curr_idx;
+  int grid_width = walls->width, grid_height = walls->height;
+  Coord_t curr_coord, move_coord;
   Mvmt_LL_t valid_dirs = LL_INIT(Mvmt);
   Mvmt_t tmp;
   GraphNode_t *curr_vert;
-  size_t curr_idx = 0;
   u8 maze_cell_fields;
 
-  do {
-    curr_vert = &(ret->vertices[curr_idx]);
-    curr_coord = *(Coord_t*)(curr_vert->data);
-    maze_cell_fields = grid[CIDX(curr_coord, grid_width)];
-    for (int i=1; i&15; i<<=1) {
-      tmp = (Mvmt_t) {.dest = dir_to_coord(i), .direction = i};
-      if (!valid_grid_coord(coords_sum(tmp.dest, curr_coord),
-            grid_width, grid_height))
-        continue;
-      if (maze_cell_fields&i)
-        continue;
-      Mvmt_LL_Push(&valid_dirs, &tmp);
-    }
-    while (valid_dirs.nmemb) {
-      Mvmt_LL_Pop(&valid_dirs, &tmp);
-      move_coord = curr_coord;
-      do {
-        move_coord.x += tmp.dest.x;
-        move_coord.y += tmp.dest.y;
-        draw_maze_cell(grid, &move_coord, grid_width, grid_height, 0x6739);
-        maze_cell_fields = grid[CIDX(move_coord, grid_width)];
-        if (tmp.direction&HORIZONTAL_MASK) {
-          maze_cell_fields |= MF_LR_WALLS;
+  curr_vert = &(ret->vertices[curr_idx]);
+  curr_coord = *(Coord_t*)(curr_vert->data);
+  maze_cell_fields = Maze_Walls_Cell(walls, curr_coord.x, curr_coord.y);
+  for (int i=1; i&15; i<<=1) {
+    tmp = (Mvmt_t) {.dest = dir_to_coord(i), .direction = i};
+    if (!valid_grid_coord(coords_sum(tmp.dest, curr_coord),
+          grid_width, grid_height))
+      continue;
+    if (maze_cell_fields&i)
+      continue;
+    Mvmt_LL_Push(&valid_dirs, &tmp);
+  }
+  while (valid_dirs.nmemb) {
+    Mvmt_LL_Pop(&valid_dirs, &tmp);
+    move_coord = curr_coord;
+    do {
+      move_coord.x += tmp.dest.x;
+      move_coord.y += tmp.dest.y;
+      MAZE_OBSERVE(task->maze, edge, move_coord);
+      maze_cell_fields = Maze_Walls_Cell(walls, move_coord.x, move_coord.y);
+      if (tmp.direction&HORIZONTAL_MASK) {
+        maze_cell_fields |= MF_LR_WALLS;
+      } else {
+        maze_cell_fields |= MF_TB_WALLS;
+      }
+      
+      maze_cell_fields = ~maze_cell_fields;
+      maze_cell_fields &= 15;
+      if (maze_cell_fields) {
+        if (Graph_Add_Vertex(ret, &move_coord)) {
+          Coord_t diff = coords_diff(curr_coord, move_coord);
+          int weight;
+          if (tmp.direction&HORIZONTAL_MASK) {
+            assert(diff.y==0);
+            if (tmp.direction == RIGHT) {
+              assert(0 > diff.x);
+              diff.x = -diff.x;
+            }
+            weight = diff.x;
+          } else {
+            assert(diff.x==0);
+            if (tmp.direction == DOWN) {
+              assert(0 > diff.y);
+              diff.y = -diff.y;
+            }
+            
+            weight = diff.y;
+          }
+          assert(0 < weight);
+          assert(coords_eq(*(Coord_t*)ret->vertices[ret->vertex_ct-1].data, move_coord));
+          assert(Graph_Add_TwoWay_Edge(ret, curr_idx, ret->vertex_ct-1, weight));
+          ++task->edge_ct;
+
         } else {
-          maze_cell_fields |= MF_TB_WALLS;
-        }
-        
-        maze_cell_fields = ~maze_cell_fields;
-        maze_cell_fields &= 15;
-        if (maze_cell_fields) {
-          if (Graph_Add_Vertex(ret, &move_coord)) {
+          GraphNode_t *mv_vert;
+          bool already_linked=false;
+          assert((mv_vert = Graph_Get_Vertex(ret, &move_coord))!=NULL);
+          assert(coords_eq(*(Coord_t*)(mv_vert->data), move_coord));
+          GraphEdge_LL_t *adjs = &(curr_vert->adj_list);
+          LL_FOREACH(LL_NODE_VAR_INITIALIZER(GraphEdge, node), node, adjs) {
+            if (node->data.dst_idx == mv_vert->idx) {
+              already_linked = true;
+              break;
+            }
+          }
+          if (already_linked) {
+            adjs = &(mv_vert->adj_list);
+            already_linked = false;
+            LL_FOREACH(LL_NODE_VAR_INITIALIZER(GraphEdge, node), node, adjs) {
+              if ((size_t)(node->data.dst_idx)==curr_idx) {
+                already_linked = true;
+                break;
+              }
+            }
+            assert(already_linked);
+          } else {
             Coord_t diff = coords_diff(curr_coord, move_coord);
             int weight;
             if (tmp.direction&HORIZONTAL_MASK) {
@@ -652,67 +976,28 @@ Graph_t *Graph_Maze(u8 *grid, const Coord_t *start, const Coord_t *end, const Ve
               weight = diff.y;
             }
             assert(0 < weight);
-            assert(coords_eq(*(Coord_t*)ret->vertices[ret->vertex_ct-1].data, move_coord));
-            assert(Graph_Add_TwoWay_Edge(ret, curr_idx, ret->vertex_ct-1, weight));
-
-          } else {
-            GraphNode_t *mv_vert;
-            bool already_linked=false;
-            assert((mv_vert = Graph_Get_Vertex(ret, &move_coord))!=NULL);
-            assert(coords_eq(*(Coord_t*)(mv_vert->data), move_coord));
-            GraphEdge_LL_t *adjs = &(curr_vert->adj_list);
-            LL_FOREACH(LL_NODE_VAR_INITIALIZER(GraphEdge, node), node, adjs) {
-              if (node->data.dst_idx == mv_vert->idx) {
-                already_linked = true;
-                break;
-              }
-            }
-            if (already_linked) {
-              adjs = &(mv_vert->adj_list);
-              already_linked = false;
-              LL_FOREACH(LL_NODE_VAR_INITIALIZER(GraphEdge, node), node, adjs) {
-                if ((size_t)(node->data.dst_idx)==curr_idx) {
-                  already_linked = true;
-                  break;
-                }
-              }
-              assert(already_linked);
-            } else {
-              Coord_t diff = coords_diff(curr_coord, move_coord);
-              int weight;
-              if (tmp.direction&HORIZONTAL_MASK) {
-                assert(diff.y==0);
-                if (tmp.direction == RIGHT) {
-                  assert(0 > diff.x);
-                  diff.x = -diff.x;
-                }
-                weight = diff.x;
-              } else {
-                assert(diff.x==0);
-                if (tmp.direction == DOWN) {
-                  assert(0 > diff.y);
-                  diff.y = -diff.y;
-                }
-                
-                weight = diff.y;
-              }
-              assert(0 < weight);
-              assert(Graph_Add_TwoWay_Edge(ret, curr_idx, mv_vert->idx, weight));
-            }
-            
+            assert(Graph_Add_TwoWay_Edge(ret, curr_idx, mv_vert->idx, weight));
+            ++task->edge_ct;
           }
-          draw_maze_cell(grid, &move_coord, grid_width, grid_height, 0x7A08);
-          if (ret->vertices+curr_idx!= curr_vert)
-            curr_vert = ret->vertices+curr_idx;
-          break;
+          
         }
-      } while (Valid_Mvmt(grid, &move_coord, &tmp, grid_dims));
-    }
-  } while (++curr_idx < ret->vertex_ct);
-
-  
+        MAZE_OBSERVE(task->maze, vertex, move_coord);
+        if (ret->vertices+curr_idx!= curr_vert)
+          curr_vert = ret->vertices+curr_idx;
+        break;
+      }
+    } while (Valid_Mvmt(walls, &move_coord, &tmp));
+  }
+  return ++task->curr_idx < ret->vertex_ct ? TASK_RUNNING : TASK_DONE;
+}
 
-  return ret;
+Graph_t *Graph_Maze(const Maze_t *maze, const Coord_t *start, const Coord_t *end) {
+  GraphMazeTask_t task;
+  if (!Graph_Maze_Begin(&task, maze, start, end))
+    return NULL;
+  while (Graph_Maze_Step(&task)==TASK_RUNNING)
+    continue;
+  return task.graph;
 }
 
 typedef struct s_dve {
@@ -750,26 +1035,169 @@ STAT_INLN Coord_t get_movement_vector(Coord_t src, Coord_t dst) {
   return COORD(0,0);
 }
 
-static void draw_maze_path(u8 *grid, const Coord_t *src, const Coord_t *dst, const Coord_t *grid_dims, u32 color) {
+#ifndef MAZE_HEADLESS
+/**
+ * @brief Log the straight run of cells strictly between src and dst as type
+ * events, for the player to animate.
+ * */
+static void log_maze_path(const Coord_t *src, const Coord_t *dst, MazeEventType_e type) {
   Coord_t c=*src, dstc=*dst, mv = get_movement_vector(dstc, c);
-  int gw = grid_dims->x, gh = grid_dims->y;
   assert(mv.x != mv.y);
   c = coords_sum(c, mv);
   while (!coords_eq(c, dstc)) {
-    draw_maze_cell(grid, &c, gw, gh, color);
-    vsync();
+    Event_Log_Push(type, c, 0);
+    c = coords_sum(c, mv);
+  }
+}
+
+/*
+ * Cell states (see RENDER_STATE). The solution path cycles through
+ * PATH_CYCLE_CT states along its length, so rotating their colors makes it
+ * pulse for a handful of palette writes a frame.
+ * */
+#define PATH_CYCLE_CT 8
+#define PATH_STATE(step) RENDER_STATE(CS_PATH + (step)%PATH_CYCLE_CT)
+typedef enum e_cell_state {
+  CS_SETTLED=0,
+  CS_TRACE,
+  CS_PATH,
+  CS_MAX = CS_PATH + PATH_CYCLE_CT
+} CellState_e;
+
+// Sprite objects marking the solver's progress
+#define OBJ_CURRENT 0
+#define OBJ_PATH_HEAD 1
+#define OBJ_FRONTIER 2
+#define SOLVE_FRONTIER_CT 64
+
+/**
+ * @brief Log the solution path from src up to (not including) dst, each cell
+ * a step further along it.
+ * @return path_len plus the number of cells logged.
+ * */
+static int log_solution_run(const Coord_t *src, const Coord_t *dst, int path_len) {
+  Coord_t c=*src, dstc=*dst, mv = get_movement_vector(dstc, c);
+  assert(mv.x != mv.y);
+  do {
+    Event_Log_Push(ME_PATH, c, path_len++);
     c = coords_sum(c, mv);
+  } while (!coords_eq(c, dstc));
+  return path_len;
+}
+
+// Cell each frontier marker is on, handed out round-robin. Kept by playback,
+// so it follows what's on screen rather than where the solver has got to.
+static Coord_t solve_frontier[SOLVE_FRONTIER_CT];
+static int solve_frontier_next = 0;
+
+STAT_INLN void Solve_Frontier_Reset(void) {
+  for (int i = 0; i < SOLVE_FRONTIER_CT; ++i)
+    solve_frontier[i] = EMPTY_COORD;
+  solve_frontier_next = 0;
+}
+
+STAT_INLN void Solve_Mark_Frontier(Coord_t cell) {
+  for (int i = 0; i < SOLVE_FRONTIER_CT; ++i) {
+    if (coords_eq(solve_frontier[i], cell))
+      return;
+  }
+  solve_frontier[solve_frontier_next] = cell;
+  Sprite_Overlay_Place(OBJ_FRONTIER + solve_frontier_next, OM_FRONTIER, cell);
+  if (++solve_frontier_next==SOLVE_FRONTIER_CT)
+    solve_frontier_next = 0;
+}
+
+STAT_INLN void Solve_Unmark_Frontier(Coord_t cell) {
+  for (int i = 0; i < SOLVE_FRONTIER_CT; ++i) {
+    if (coords_eq(solve_frontier[i], cell)) {
+      solve_frontier[i] = EMPTY_COORD;
+      Sprite_Overlay_Hide(OBJ_FRONTIER + i);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Draw a logged event; the player's callback. userdata is the maze.
+ * Events forced out of a full log (overflow) arrive mid-step, so they only
+ * queue redraws and move sprites; the view follows played events alone.
+ * */
+static void Maze_Event_Play_cb(const MazeEvent_t *event, bool overflow, void *userdata) {
+  static const u32 WALK_COLORS[] = {
+    [MWM_OFF] = DIRTY_CELL_FILL,
+    [MWM_ON] = DIRTY_CELL_FILL|0x7A08,
+    [MWM_START] = DIRTY_CELL_FILL|0x7FFF,
+  };
+  const Maze_t *maze = userdata;
+  const Coord_t C = COORD(event->x, event->y);
+  switch (event->type) {
+  case ME_CARVE:
+    Dirty_Cells_Mark(maze, &C, 0x7FFF);
+    break;
+  case ME_WALK:
+    if (event->arg <= MWM_START)
+      Dirty_Cells_Mark(maze, &C, WALK_COLORS[event->arg]);
+    break;
+  case ME_VERTEX:
+    Dirty_Cells_Mark(maze, &C, 0x7A08);
+    break;
+  case ME_EDGE:
+    Dirty_Cells_Mark(maze, &C, 0x6739);
+    break;
+  case ME_VISIT:
+    Dirty_Cells_Mark(maze, &C, RENDER_STATE(CS_SETTLED));
+    Solve_Unmark_Frontier(C);
+    Sprite_Overlay_Place(OBJ_CURRENT, OM_CURRENT, C);
+    if (!overflow)
+      Maze_Renderer_Follow(C);
+    break;
+  case ME_RELAX:
+    Solve_Mark_Frontier(C);
+    break;
+  case ME_TRACE:
+    Dirty_Cells_Mark(maze, &C, RENDER_STATE(CS_TRACE));
+    if (!overflow)
+      Maze_Renderer_Follow(C);
+    break;
+  case ME_PATH:
+    Dirty_Cells_Mark(maze, &C, PATH_STATE(event->arg));
+    Sprite_Overlay_Place(OBJ_PATH_HEAD, OM_PATH_HEAD, C);
+    if (!overflow)
+      Maze_Renderer_Follow(C);
+    break;
+  default:
+    break;
   }
 }
-GraphNode_t **Dijkstras(Graph_t *graph, u32 src, u32 dst) {
+#endif  /* ! defined(MAZE_HEADLESS) */
+
+/*
+ * Dijkstras as a resumable task: each step settles one vertex, reporting it
+ * and every vertex whose distance it lowers to the maze's observer. Playback
+ * shows the vertex being settled and the most recently reached unsettled ones
+ * (the frontier) with sprite markers rather than painting them into the maze.
+ * */
+typedef struct s_dijkstra_task {
+  const Maze_t *maze;
+  Graph_t *graph;
+  BinaryTree_t *unvisited;
+  u32 *dist;
+  GraphNode_t **prevs;
+  u32 dst;
+  // Operations on unvisited, the priority queue: inserts, removals and
+  // lookups
+  u32 pq_ops;
+} DijkstraTask_t;
+
+static bool Dijkstras_Begin(DijkstraTask_t *task, const Maze_t *maze, Graph_t *graph, u32 src, u32 dst) {
   GraphNode_t **prevs;
   u32 *dist;
   if (!graph)
-    return NULL;
+    return false;
   if (src < 0 || src >= graph->vertex_ct)
-    return NULL;
+    return false;
   if (dst < 0 || dst >= graph->vertex_ct)
-    return NULL;
+    return false;
 
   BinaryTree_t *unvisited = BinaryTree_Create(malloc, free, NULL, NULL, dve_cmp, sizeof(DijkstraVertent_t), NULL);
   assert(NULL!=unvisited);
@@ -797,150 +1225,524 @@ GraphNode_t **Dijkstras(Graph_t *graph, u32 src, u32 dst) {
 
     assert(BinaryTree_Insert(unvisited, &tmp)==1);
   }
-  
+  *task = (DijkstraTask_t){
+    .maze = maze, .graph = graph, .unvisited = unvisited,
+    .dist = dist, .prevs = prevs, .dst = dst, .pq_ops = graph->vertex_ct + 2
+  };
+  return true;
+}
+
+static TaskStatus_e Dijkstras_Step(void *state) {
+  DijkstraTask_t *task = state;
+  Graph_t *graph = task->graph;
+  BinaryTree_t *unvisited = task->unvisited;
+  u32 *dist = task->dist;
+  GraphNode_t **prevs = task->prevs;
   DijkstraVertent_t tree_query={0}, *curvertent;
-  Coord_t dims = COORD(GRID_WIDTH, GRID_HEIGHT);
   GraphNode_t *curvert;
   GraphEdge_LL_t *curvert_adjlist;
   u32 nextdist, curdist, altdist, next_idx;
-  while (BinaryTree_Element_Count(unvisited)) {
+  bool reached = false;
+  if (BinaryTree_Element_Count(unvisited)) {
     assert((curvertent= BinaryTree_Remove_Minimum(unvisited))!=NULL);
+    ++task->pq_ops;
     assert(curvertent->distance!=0xFFFFFFFFUL);
-    if (curvertent->vertex_index == dst) {
-      assert(prevs[dst]!=NULL && dist[dst]!=0xFFFFFFFFUL);
-      free((void*)curvertent);
-      break;
-    }
-    curvert = graph->vertices + (curvertent->vertex_index);
-    draw_maze_cell((u8*)GRID, curvert->data, GRID_WIDTH, GRID_HEIGHT, 0x7A08);
-    curvert_adjlist = &(curvert->adj_list);
-    curdist = curvertent->distance;
-    LL_FOREACH (LL_NODE_VAR_INITIALIZER(GraphEdge, node), node, curvert_adjlist) {
-      tree_query.vertex_index = next_idx = node->data.dst_idx;
-      tree_query.distance = nextdist = dist[next_idx];
-      bool node_unvisited = BinaryTree_Contains(unvisited, &tree_query);
-      if (!node_unvisited) {
-        continue;
-      }
+    if (curvertent->vertex_index == task->dst) {
+      assert(prevs[task->dst]!=NULL && dist[task->dst]!=0xFFFFFFFFUL);
+      reached = true;
+    } else {
+      curvert = graph->vertices + (curvertent->vertex_index);
+      MAZE_OBSERVE(task->maze, visit, *(Coord_t*)curvert->data);
+      curvert_adjlist = &(curvert->adj_list);
+      curdist = curvertent->distance;
+      LL_FOREACH (LL_NODE_VAR_INITIALIZER(GraphEdge, node), node, curvert_adjlist) {
+        tree_query.vertex_index = next_idx = node->data.dst_idx;
+        tree_query.distance = nextdist = dist[next_idx];
+        bool node_unvisited = BinaryTree_Contains(unvisited, &tree_query);
+        ++task->pq_ops;
+        if (!node_unvisited) {
+          continue;
+        }
 
-      altdist = (unsigned)node->data.weight + curdist;
-      if (altdist >= nextdist) {
-        continue;
-      }
-      draw_maze_path((u8*)GRID, curvert->data, graph->vertices[next_idx].data, &dims, 0x6739);
-      tree_query.distance = nextdist;
-      tree_query.vertex_index = next_idx;
-      assert(BinaryTree_Remove(unvisited, &tree_query)==1);
-      tree_query.distance = dist[next_idx] = altdist;
-      assert(BinaryTree_Insert(unvisited, &tree_query)==1);
-      prevs[next_idx] = curvert;
+        altdist = (unsigned)node->data.weight + curdist;
+        if (altdist >= nextdist) {
+          continue;
+        }
+        MAZE_OBSERVE(task->maze, relax, *(Coord_t*)graph->vertices[next_idx].data);
+        tree_query.distance = nextdist;
+        tree_query.vertex_index = next_idx;
+        assert(BinaryTree_Remove(unvisited, &tree_query)==1);
+        tree_query.distance = dist[next_idx] = altdist;
+        assert(BinaryTree_Insert(unvisited, &tree_query)==1);
+        task->pq_ops += 2;
+        prevs[next_idx] = curvert;
 
+      }
     }
     free((void*)curvertent);
+    if (!reached)
+      return TASK_RUNNING;
   }
   free((void*)dist);
   BinaryTree_Destroy(unvisited);
-  return prevs;
+  task->dist = NULL;
+  task->unvisited = NULL;
+  return TASK_DONE;
+}
+
+GraphNode_t **Dijkstras(const Maze_t *maze, Graph_t *graph, u32 src, u32 dst) {
+  DijkstraTask_t task;
+  if (!Dijkstras_Begin(&task, maze, graph, src, dst))
+    return NULL;
+  while (Dijkstras_Step(&task)==TASK_RUNNING)
+    continue;
+  return task.prevs;
+}
+
+
+
+#ifndef MAZE_HEADLESS
+/*
+ * Only the first call draws the maze; every call after that just copies the
+ * clean image saved from it back, wiping whatever was drawn over it since.
+ * */
+static void draw_maze(const Maze_t *maze) {
+  if (Maze_Renderer_Restore())
+    return;
+  MAZE_RENDERER->draw_walls(&MAZE_GEOMETRY, &maze->walls, 0x7FFF);
+  Maze_Renderer_Snapshot();
+}
+
+/*
+ * Generation task. Only plain Wilson's runs stepwise; the exit-arrow and
+ * hybrid variants, Eller's, Kruskal's, Prim's and the backtracker don't have a
+ * resumable form yet and run to completion in a single step, however many
+ * frames that holds the scheduler up for.
+ * */
+typedef struct s_gen_task {
+  Maze_t *maze;
+  MazeGenId_e id;
+  WilsonTask_t wilson;
+} GenTask_t;
+
+static bool Gen_Begin(GenTask_t *task, MazeGenId_e id, Maze_t *maze, u32 seed) {
+  Rng_Seed(&MAZE_RNG, seed, RNG_STREAM_MAZE);
+  maze->seed = seed;
+  maze->gen_id = id;
+  task->maze = maze;
+  task->id = id;
+  if (id==MG_WILSON)
+    return Wilsons_Begin(&task->wilson, maze);
+  return true;
+}
+
+static TaskStatus_e Gen_Step(void *state) {
+  GenTask_t *task = state;
+  if (task->id!=MG_WILSON)  // Maze_Generate packs the walls itself
+    return Maze_Generate(task->id, task->maze) ? TASK_DONE : TASK_FAILED;
+  const TaskStatus_e STATUS = Wilsons_Step(&task->wilson);
+  if (STATUS==TASK_DONE)
+    Maze_Walls_From_Grid(&task->maze->walls, task->maze->grid);
+  return STATUS;
+}
+
+#ifndef _DEBUG_LOG_TO_SAVEFILE_
+/*
+ * Stands in for the generation task when the maze comes out of SRAM instead.
+ * */
+typedef struct s_load_task {
+  Maze_t *maze;
+  int slot;
+} LoadTask_t;
+
+static TaskStatus_e Load_Step(void *state) {
+  LoadTask_t *task = state;
+  if (!Maze_Save_Load(task->slot, task->maze))
+    return TASK_FAILED;
+  draw_maze(task->maze);
+  return TASK_DONE;
+}
+
+/**
+ * @brief If SRAM holds a maze of maze's size, offer to load it.
+ * @return the slot to load, or -1 to generate a new maze.
+ * */
+static int Maze_Save_Prompt(const Maze_t *maze) {
+  int slot;
+  if (!Maze_Save_Init() || (slot = Maze_Save_Find(maze->width, maze->height)) < 0)
+    return -1;
+  mode3_printf(0, 0, 0, "Saved %dx%d maze found.\nA: load it\nB: generate a new one",
+      maze->width, maze->height);
+  do vsync(); while (Poll_Keys(), !(K_STROKE(A) || K_STROKE(B)));
+  mode3_clear_screen();
+  return K_STROKE(A) ? slot : -1;
+}
+#endif  /* ! defined(_DEBUG_LOG_TO_SAVEFILE_) */
+
+/*
+ * Events a second each phase's log plays back at. Hold R to fast-forward, and
+ * press B to skip to the end of the phase. SELECT shows or hides the HUD.
+ * */
+#ifndef MAZE_GEN_PLAY_RATE
+#define MAZE_GEN_PLAY_RATE 3840
+#endif
+#ifndef MAZE_GRAPH_PLAY_RATE
+#define MAZE_GRAPH_PLAY_RATE 960
+#endif
+#ifndef MAZE_SOLVE_PLAY_RATE
+#define MAZE_SOLVE_PLAY_RATE 480
+#endif
+#ifndef MAZE_PATH_PLAY_RATE
+#define MAZE_PATH_PLAY_RATE 60
+#endif
+
+#ifndef MAZE_HUD_PERIOD
+// Frames between HUD refreshes
+#define MAZE_HUD_PERIOD 8
+#endif
+
+/*
+ * What the HUD reports on, set up by main all at once. Phases that haven't
+ * run yet read 0 across the board.
+ * */
+typedef struct s_maze_hud {
+  const Task_t *phases;
+  const GraphMazeTask_t *graph;
+  const DijkstraTask_t *solve;
+  // Heap in use as of the last phase to begin or end. mallinfo walks the whole
+  // free list, too slow to call every refresh.
+  u32 heap_bytes;
+} MazeHud_t;
+
+static MazeHud_t hud = {0};
+// SELECT was pressed; the HUD shows or hides at the next VBlank
+static bool hud_toggle = false;
+
+STAT_INLN void Maze_Hud_Sample_Heap(void) {
+  hud.heap_bytes = mallinfo().uordblks;
+}
+
+static void Maze_Hud_Update(void) {
+  if (!hud.phases || !hud.graph || !hud.solve)
+    return;
+  for (int i = 0; i < 3; ++i) {
+    Hud_Printf(i, "%-8s %10lu cycles %6lu frames %8lu steps", hud.phases[i].name,
+        (unsigned long)hud.phases[i].cycles, (unsigned long)hud.phases[i].frames,
+        (unsigned long)hud.phases[i].steps);
+  }
+  Hud_Printf(3, "heap %lu bytes   vertices %lu   edges %lu",
+      (unsigned long)hud.heap_bytes,
+      (unsigned long)(hud.graph->graph ? hud.graph->graph->vertex_ct : 0),
+      (unsigned long)hud.graph->edge_ct);
+  Hud_Printf(4, "pq ops %lu", (unsigned long)hud.solve->pq_ops);
+}
 
+static void Scheduler_Poll_Keys_cb(void *userdata) {
+  (void)userdata;
+  Poll_Keys();
+  Event_Player_Fast_Forward(K_HELD(R));
+  if (K_STROKE(B))
+    Event_Player_Skip();
+  if (K_STROKE(SEL))
+    hud_toggle = true;
+  // Only formats the lines; the VBlank hook puts them on screen
+  if (hud_toggle || (Hud_Visible() && !(SCHEDULER_FRAME_CT%MAZE_HUD_PERIOD)))
+    Maze_Hud_Update();
 }
 
+static void Scheduler_Flush_Cells_cb(void *userdata) {
+  (void)userdata;
+  if (hud_toggle) {
+    Hud_Toggle();
+    hud_toggle = false;
+  }
+  Hud_Flush();
+  Maze_Renderer_Present();
+  Event_Player_Tick();
+  Dirty_Cells_Flush(DIRTY_FLUSH_VCOUNT_END);
+}
 
+/**
+ * @brief Keep playing the event log a frame at a time until it's empty, then
+ * draw whatever cells are still pending.
+ * */
+static void Maze_Events_Play_Out(void) {
+  while (Event_Log_Pending()) {
+    vsync();
+    Scheduler_Flush_Cells_cb(NULL);
+    Scheduler_Poll_Keys_cb(NULL);
+  }
+  Dirty_Cells_Drain();
+}
+#else
+#ifndef MAZE_HEADLESS_BATCH_CT
+#define MAZE_HEADLESS_BATCH_CT 8
+#endif
 
-static void draw_maze(u8 *grid, int grid_width, int grid_height) {
-  Coord_t c;
-  for (c.y = 0; c.y < grid_height; ++c.y) {
-    for (c.x= 0; c.x < grid_width; ++c.x) {
-      draw_maze_cell(grid, &c, grid_width, grid_height, 0x7FFF);
+/**
+ * @brief Generate, graph and solve MAZE_HEADLESS_BATCH_CT mazes per generator,
+ * seeds counting up from seed, and print the average cycles each phase took.
+ * No observer, no renderer: only the algorithms themselves are timed.
+ * */
+static void Maze_Headless_Batch(Maze_t *maze, u32 seed) {
+  const Coord_t START = COORD(0, 0), END = COORD(maze->width-1, maze->height-1);
+  mode3_clear_screen();
+  mode3_printf(0, 0, 0, "Avg cycles, %dx%d, %d mazes:\n\tgen\tgraph\tsolve",
+      maze->width, maze->height, MAZE_HEADLESS_BATCH_CT);
+  for (int id = 0; id < MG_MAX; ++id) {
+    u32 gen = 0, graph = 0, solve = 0;
+    for (int i = 0; i < MAZE_HEADLESS_BATCH_CT; ++i) {
+      Cycle_Timer_Start();
+      assert(Maze_Generate_Seeded(id, maze, seed + i));
+      gen += Cycle_Timer_Read();
+      Cycle_Timer_Start();
+      Graph_t *maze_graph = Graph_Maze(maze, &START, &END);
+      graph += Cycle_Timer_Read();
+      assert(maze_graph!=NULL);
+      Cycle_Timer_Start();
+      GraphNode_t **prevs = Dijkstras(maze, maze_graph, 0, 1);
+      solve += Cycle_Timer_Read();
+      assert(prevs!=NULL);
+      free(prevs);
+      Graph_Close(maze_graph);
     }
+    mode3_printf(0, (id+2)*8, 0, "%s\t%lu\t%lu\t%lu", MAZE_GENERATORS[id].name,
+        (unsigned long)(gen/MAZE_HEADLESS_BATCH_CT),
+        (unsigned long)(graph/MAZE_HEADLESS_BATCH_CT),
+        (unsigned long)(solve/MAZE_HEADLESS_BATCH_CT));
+  }
+}
+#endif  /* defined(MAZE_HEADLESS) */
+
+#if !defined(GRID_WIDTH) || !defined(GRID_HEIGHT)
+/**
+ * @brief Let the player pick a maze size from MAZE_SIZE_PRESETS with L/R,
+ * confirming with START.
+ * */
+static Coord_t Maze_Size_Select(void) {
+  int sel = MAZE_SIZE_PRESET_DEFAULT;
+  mode3_clear_screen();
+  mode3_printf(0, 16, 0, "L/R: change size\nSTART: generate");
+  for (;;) {
+    mode3_printf(0, 0, 0, "Maze size: %3d x %-3d", MAZE_SIZE_PRESETS[sel].x, MAZE_SIZE_PRESETS[sel].y);
+    do vsync(); while (Poll_Keys(), !(K_STROKE(L) || K_STROKE(R) || K_STROKE(START)));
+    if (K_STROKE(START))
+      break;
+    if (K_STROKE(L))
+      sel = sel ? sel-1 : MAZE_SIZE_PRESET_CT-1;
+    else if (++sel==MAZE_SIZE_PRESET_CT)
+      sel = 0;
   }
+  mode3_clear_screen();
+  return MAZE_SIZE_PRESETS[sel];
 }
+#endif  /* ! (defined(GRID_WIDTH) && defined(GRID_HEIGHT)) */
 
 int main(void) {
   IRQ_Init(NULL);
   IRQ_Add(II_VBLANK, NULL, II_MAX);
   REG_DISPLAY_CNT=0x0403;
+  u32 seed;
 #ifdef RNG_SEED
-  srand(RNG_SEED);
+  seed = RNG_SEED;
 #elif 1
-  // Cool maze seeds :)
-//  srand(0x27D9440DUL);
-//  srand(0x3CB76F4DUL);
-//  srand(0x6FAB21B7UL);
-//  srand(0x3D1E32C6UL);
-//  srand(0x801BC0C1UL);
-//  srand(0x0A99B79BUL);
-//  srand(0x043EC82CUL);
-//  srand(0xAA41D7F7UL);
-//  srand(0x3777C479UL);
-//  srand(0x95867A5FUL);
-//  srand(0x27D9440EUL);
-//  srand(0xE573C496UL);
-//  srand(0x7612FB02UL);
-//  srand(0xA739BD0AUL);
-  srand(0x4DA23792UL);
+  // Cool maze seeds :) (picked under newlib rand(), so they carve different
+  // mazes now, but still the same maze on every platform)
+//  seed = 0x27D9440DUL;
+//  seed = 0x3CB76F4DUL;
+//  seed = 0x6FAB21B7UL;
+//  seed = 0x3D1E32C6UL;
+//  seed = 0x801BC0C1UL;
+//  seed = 0x0A99B79BUL;
+//  seed = 0x043EC82CUL;
+//  seed = 0xAA41D7F7UL;
+//  seed = 0x3777C479UL;
+//  seed = 0x95867A5FUL;
+//  seed = 0x27D9440EUL;
+//  seed = 0xE573C496UL;
+//  seed = 0x7612FB02UL;
+//  seed = 0xA739BD0AUL;
+  seed = 0x4DA23792UL;
 #endif
 #ifdef _DEBUG_LOG_TO_SAVEFILE_
   debug_log_initialize();
 #endif  /* DEBUG LOGS TO .SAV FILE */
-  Wilsons_Algo((u8*)GRID, GRID_WIDTH, GRID_HEIGHT);
-  Coord_t start=COORD(0,0), end=COORD(GRID_WIDTH-1, GRID_HEIGHT-1), dims=COORD(GRID_WIDTH,GRID_HEIGHT), *c;
-  Graph_t *maze_graph = Graph_Maze((u8*)GRID, &start, &end, &dims);
-  assert(maze_graph!=NULL);
-
+#if defined(GRID_WIDTH) && defined(GRID_HEIGHT)
+  Maze_t *maze = Maze_Create(GRID_WIDTH, GRID_HEIGHT);
+#else
+  Coord_t size = Maze_Size_Select();
+  Maze_t *maze = Maze_Create(size.x, size.y);
+#endif
+  assert(maze!=NULL);
+#ifdef MAZE_GEN_BENCHMARK
+  Maze_Generator_Benchmark(maze);
   do vsync(); while (Poll_Keys(), !K_STROKE(START));
-  draw_maze((u8*)GRID, GRID_WIDTH, GRID_HEIGHT);
+  mode3_clear_screen();
+#endif
+#ifdef MAZE_HEADLESS
+  Maze_Headless_Batch(maze, seed);
+  Maze_Destroy(maze);
+#else
+  assert(Dirty_Cells_Init(maze));
+  assert(Event_Log_Init(Maze_Event_Play_cb, maze));
+  maze->observer = &EVENT_LOG_OBSERVER;
+  Scheduler_Init(SCHEDULER_DEFAULT_BUDGET, Scheduler_Poll_Keys_cb, NULL);
+  Scheduler_Set_VBlank_Hook(Scheduler_Flush_Cells_cb, NULL);
+  GenTask_t gen_task;
+  GraphMazeTask_t graph_task = {0};
+  DijkstraTask_t solve_task = {0};
+  Task_t phases[3] = {
+    {.name = "Generate", .step = Gen_Step, .state = &gen_task},
+    {.name = "Graph", .step = Graph_Maze_Step, .state = &graph_task},
+    {.name = "Solve", .step = Dijkstras_Step, .state = &solve_task},
+  };
+
+#ifndef _DEBUG_LOG_TO_SAVEFILE_
+  LoadTask_t load_task = {.maze = maze, .slot = Maze_Save_Prompt(maze)};
+#endif  /* ! defined(_DEBUG_LOG_TO_SAVEFILE_) */
+  // Tiles are one 8x8 cell each. Mazes that fit on screen that way, and ones
+  // whose cells would come out too small to follow on a bitmap, get the
+  // tiled renderer, the latter scrolling with the solver; the rest fit the
+  // screen on the double-buffered Mode 4 bitmap
+  const int BITMAP_CELL_W = SCREEN_WIDTH/maze->width, BITMAP_CELL_H = SCREEN_HEIGHT/maze->height;
+  const bool TILED = (BITMAP_CELL_W >= 8 && BITMAP_CELL_H >= 8)
+    || BITMAP_CELL_W < MAZE_MIN_BITMAP_CELL_PX || BITMAP_CELL_H < MAZE_MIN_BITMAP_CELL_PX;
+  if (!TILED || !Maze_Renderer_Use(&MAZE_RENDERER_TILED, maze->width, maze->height))
+    assert(Maze_Renderer_Use(&MAZE_RENDERER_MODE4, maze->width, maze->height));
+  Sprite_Overlay_Init(&MAZE_GEOMETRY);
+  // Fails, leaving SELECT doing nothing, under the bitmap renderer
+  Hud_Init();
+  hud = (MazeHud_t){.phases = phases, .graph = &graph_task, .solve = &solve_task};
+  Maze_Hud_Sample_Heap();
+  Maze_Renderer_Set_State_Color(CS_SETTLED, 0x7A08);
+  Maze_Renderer_Set_State_Color(CS_TRACE, 0x6739);
+  for (int i = 0; i < PATH_CYCLE_CT; ++i)
+    Maze_Renderer_Set_State_Color(CS_PATH + i, i ? 0x7A08 : 0x7F18);
+#ifndef _DEBUG_LOG_TO_SAVEFILE_
+  if (load_task.slot >= 0) {
+    phases[0] = (Task_t){.name = "Load", .step = Load_Step, .state = &load_task};
+    if (Scheduler_Run(&phases[0])!=TASK_DONE)
+      load_task.slot = -1;
+    Maze_Hud_Sample_Heap();
+  }
+  if (load_task.slot < 0)
+#endif  /* ! defined(_DEBUG_LOG_TO_SAVEFILE_) */
+  {
+    phases[0] = (Task_t){.name = "Generate", .step = Gen_Step, .state = &gen_task};
+    Event_Player_Set_Rate(MAZE_GEN_PLAY_RATE);
+    assert(Gen_Begin(&gen_task, MAZE_GENERATOR, maze, seed));
+    Maze_Hud_Sample_Heap();
+    assert(Scheduler_Run(&phases[0])==TASK_DONE);
+    Maze_Hud_Sample_Heap();
+  }
+  Maze_Events_Play_Out();
+  Coord_t start=COORD(0,0), end=COORD(maze->width-1, maze->height-1), *c;
+  Event_Player_Set_Rate(MAZE_GRAPH_PLAY_RATE);
+  assert(Graph_Maze_Begin(&graph_task, maze, &start, &end));
+  Maze_Hud_Sample_Heap();
+  assert(Scheduler_Run(&phases[1])==TASK_DONE);
+  Maze_Hud_Sample_Heap();
+  Maze_Events_Play_Out();
+  Graph_t *maze_graph = graph_task.graph;
+
+  do Maze_Renderer_VSync(); while (Poll_Keys(), !K_STROKE(START));
+  draw_maze(maze);
   
   const size_t sz = maze_graph->vertex_ct;
   GraphNode_t *vertices = maze_graph->vertices;
   GraphEdge_LL_t *adjs;
 
   
+  Event_Player_Set_Rate(MAZE_GRAPH_PLAY_RATE);
   for (size_t i = 0; i < sz; ++i) {
 
     c = vertices[i].data;
-    draw_maze_cell((u8*)GRID, c, GRID_WIDTH, GRID_HEIGHT, 0x7A08);
+    Event_Log_Push(ME_VERTEX, *c, 0);
     adjs = Graph_Get_Vertex_Adjacents(maze_graph, i);
     assert(adjs!=NULL);
     LL_FOREACH (LL_NODE_VAR_INITIALIZER(GraphEdge, node), node, adjs) {
-      draw_maze_path((u8*)GRID, c, vertices[node->data.dst_idx].data, &dims, 0x6739);
+      log_maze_path(c, vertices[node->data.dst_idx].data, ME_EDGE);
     }
-    vsync();
   }
+  Maze_Events_Play_Out();
   
-  do vsync(); while (Poll_Keys(), !K_STROKE(START));
-  draw_maze((u8*)GRID, GRID_WIDTH, GRID_HEIGHT);
-
-  GraphNode_t **prevs = Dijkstras(maze_graph, 0, 1), **stack = malloc(sizeof(void*)*(maze_graph->vertex_ct)), *cur, *nxt;
+  do Maze_Renderer_VSync(); while (Poll_Keys(), !K_STROKE(START));
+  draw_maze(maze);
+
+  Solve_Frontier_Reset();
+  Event_Player_Set_Rate(MAZE_SOLVE_PLAY_RATE);
+  assert(Dijkstras_Begin(&solve_task, maze, maze_graph, 0, 1));
+  Maze_Hud_Sample_Heap();
+  assert(Scheduler_Run(&phases[2])==TASK_DONE);
+  Maze_Hud_Sample_Heap();
+  Maze_Events_Play_Out();
+  Sprite_Overlay_Hide_All();
+  GraphNode_t **prevs = solve_task.prevs, **stack = malloc(sizeof(void*)*(maze_graph->vertex_ct)), *cur, *nxt;
   assert(prevs!=NULL && stack!=NULL);
-  do vsync(); while (Poll_Keys(), !K_STROKE(START));
+  do Maze_Renderer_VSync(); while (Poll_Keys(), !K_STROKE(START));
   
-  draw_maze((u8*)GRID, GRID_WIDTH, GRID_HEIGHT);
-  vsync();
+  draw_maze(maze);
+  Maze_Renderer_VSync();
   int top = -1;
   int idx = 1;
-  draw_maze_cell((u8*)GRID, vertices[idx].data, GRID_WIDTH, GRID_HEIGHT, 0x6739);
+  Event_Player_Set_Rate(MAZE_PATH_PLAY_RATE);
+  Event_Log_Push(ME_TRACE, *(Coord_t*)vertices[idx].data, 0);
   while ((cur=prevs[idx])) {
-    vsync();
-    draw_maze_cell((u8*)GRID, cur->data, GRID_WIDTH, GRID_HEIGHT, 0x6739);
+    Event_Log_Push(ME_TRACE, *(Coord_t*)cur->data, 0);
     stack[++top] = vertices+idx;
     idx = cur - vertices;
   }
   free(prevs);
-  do vsync(); while (Poll_Keys(), !K_STROKE(START));
+  Maze_Events_Play_Out();
+  do Maze_Renderer_VSync(); while (Poll_Keys(), !K_STROKE(START));
   assert(idx == 0);
   cur = vertices;
+  int path_len = 0;
+  Event_Player_Set_Rate(MAZE_PATH_PLAY_RATE);
   while (-1 < top) {
-    draw_maze_cell(((u8*)GRID), cur->data, GRID_WIDTH, GRID_HEIGHT, 0x7A08);
-    vsync();
     nxt = stack[top--];
-    draw_maze_path((u8*)GRID, cur->data, nxt->data, &dims, 0x7A08);
+    path_len = log_solution_run(cur->data, nxt->data, path_len);
     cur = nxt;
   }
+  Event_Log_Push(ME_PATH, *(Coord_t*)cur->data, path_len);
+  Maze_Events_Play_Out();
 
   // TODO: Fix Graph_Maze so that vertices that spawned from dst traversal have connecting edges to those from src
   
   free(stack);
   Graph_Close(maze_graph);
+  graph_task.graph = NULL;
+
+  for (u32 frame = 0; Poll_Keys(), !K_STROKE(START); ++frame) {
+    Maze_Renderer_VSync();
+    if (!(frame&3))
+      Maze_Renderer_Cycle_States(CS_PATH, PATH_CYCLE_CT);
+  }
+  hud = (MazeHud_t){0};
+  Hud_Close();
+  Sprite_Overlay_Close();
+  Maze_Renderer_Release();
+  mode3_clear_screen();
+  mode3_printf(0, 0, 0, "Frames per phase:");
+  for (int i = 0; i < 3; ++i) {
+    mode3_printf(0, (i+1)*8, 0, "%s\t%lu (%lu steps)", phases[i].name,
+        (unsigned long)phases[i].frames, (unsigned long)phases[i].steps);
+  }
+#ifndef _DEBUG_LOG_TO_SAVEFILE_
+  mode3_printf(0, 40, 0, "A: save maze\nB: save seed only\nSTART: don't save");
+  do vsync(); while (Poll_Keys(), !(K_STROKE(A) || K_STROKE(B) || K_STROKE(START)));
+  if (!K_STROKE(START)) {
+    int slot = Maze_Save_Store(maze, K_STROKE(A) ? MSF_PACKED : MSF_SEED);
+    if (slot < 0)
+      mode3_printf(0, 72, 0, "Save failed (%d saved)", Maze_Save_Count());
+    else
+      mode3_printf(0, 72, 0, "Saved to slot %d", slot);
+  }
+#endif  /* ! defined(_DEBUG_LOG_TO_SAVEFILE_) */
+  Event_Log_Close();
+  Dirty_Cells_Close();
+  Maze_Destroy(maze);
+#endif  /* ! defined(MAZE_HEADLESS) */
 
     
   while (1);
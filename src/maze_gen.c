@@ -0,0 +1,345 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_types.h"
+#include "gba_funcs.h"
+#include "cycle_timer.h"
+#include "maze.h"
+#include "maze_walls.h"
+#include "mode3_io.h"
+#include "rng.h"
+#include <stdlib.h>
+#include <assert.h>
+
+#ifndef MAZE_HYBRID_AB_PERCENT
+#define MAZE_HYBRID_AB_PERCENT 30
+#endif  /* ! defined(MAZE_HYBRID_AB_PERCENT) */
+
+// Cells and walls are passed around packed as (y<<16)|x so that the engines
+// below never need a division to get back to a coordinate for drawing.
+#define PACK_COORD(x, y) ((((u32)(y))<<16)|((u32)(x)))
+#define PACKED_X(p) ((int)((p)&0xFFFF))
+#define PACKED_Y(p) ((int)((p)>>16))
+
+// Bit 4 of a cell (the lowest exit-arrow bit) is free while these engines run,
+// so randomized Prim's borrows it as the "already on the frontier" flag.
+#define MF_FRONTIER (1<<MF_EXIT_ARROW_SHIFT)
+
+static const Direction_e GEN_DIRS[4] = {LEFT, RIGHT, UP, DOWN};
+
+#define gen_observe_carve(maze, x, y) MAZE_OBSERVE(maze, carve, COORD(x, y))
+
+/**
+ * @brief The cell one step from (x, y) in dir. nx and ny are always written,
+ * but only name a neighbour when this returns true.
+ * */
+STAT_INLN bool gen_neighbour(int x, int y, Direction_e dir, int grid_width, int grid_height, int *nx, int *ny) {
+  *nx = x, *ny = y;
+  switch (dir) {
+  case LEFT:
+    *nx = x-1;
+    return x > 0;
+  case RIGHT:
+    *nx = x+1;
+    return x+1 < grid_width;
+  case UP:
+    *ny = y-1;
+    return y > 0;
+  case DOWN:
+    *ny = y+1;
+    return y+1 < grid_height;
+  default:
+    return false;
+  }
+}
+
+/*
+ * Kruskal's algorithm
+ * */
+
+STAT_INLN u32 uf_find(u32 *parent, u32 idx) {
+  // Path halving: point every other node on the way up at its grandparent
+  while (parent[idx]!=idx) {
+    parent[idx] = parent[parent[idx]];
+    idx = parent[idx];
+  }
+  return idx;
+}
+
+/**
+ * @brief Kruskal's algorithm over a shuffled list of every interior wall, with
+ * a union-find (path halving + union by rank) to reject walls whose two cells
+ * are already connected. Working memory: one u32 per wall, one u32 plus one
+ * byte per cell, all allocated up front.
+ * */
+bool Kruskals_Algo(Maze_t *maze) {
+  u8 *grid = maze->grid;
+  const int grid_width = maze->width, grid_height = maze->height;
+  const u32 N = grid_width*grid_height;
+  const u32 EDGE_CT = (grid_width-1)*grid_height + grid_width*(grid_height-1);
+  u32 *edges, *parent, joined = 0, e = 0;
+  u8 *rank;
+  Grid_Reset(maze);
+  edges = malloc((EDGE_CT+1)*sizeof(u32));
+  parent = malloc(N*sizeof(u32));
+  rank = calloc(N, sizeof(u8));
+  if (!edges || !parent || !rank) {
+    free(edges);
+    free(parent);
+    free(rank);
+    return false;
+  }
+  for (u32 i = 0; i < N; ++i)
+    parent[i] = i;
+
+  // Walls are packed coords of the left/top cell, with bit 15 of x flagging
+  // the wall below that cell rather than the one to its right.
+  for (int y = 0; y < grid_height; ++y) {
+    for (int x = 0; x < grid_width; ++x) {
+      if (x+1 < grid_width)
+        edges[e++] = PACK_COORD(x, y);
+      if (y+1 < grid_height)
+        edges[e++] = PACK_COORD(x, y)|0x8000;
+    }
+  }
+  assert(e==EDGE_CT);
+  for (u32 i = EDGE_CT; i > 1; --i) {
+    u32 j = Rng_Range(&MAZE_RNG, i), tmp = edges[i-1];
+    edges[i-1] = edges[j];
+    edges[j] = tmp;
+  }
+
+  if (N==1) {
+    grid[0] |= MF_INITIALIZED;
+    gen_observe_carve(maze, 0, 0);
+  }
+  for (e = 0; e < EDGE_CT && joined+1 < N; ++e) {
+    u32 edge = edges[e];
+    bool down = edge&0x8000;
+    int x = PACKED_X(edge)&0x7FFF, y = PACKED_Y(edge);
+    u32 a = x + y*grid_width, b = down ? a+grid_width : a+1;
+    u32 ra = uf_find(parent, a), rb = uf_find(parent, b);
+    if (ra==rb)
+      continue;
+    if (rank[ra] < rank[rb]) {
+      parent[ra] = rb;
+    } else {
+      parent[rb] = ra;
+      if (rank[ra]==rank[rb])
+        ++rank[ra];
+    }
+    Grid_Carve_Idx(maze, a, down ? DOWN : RIGHT);
+    grid[a] |= MF_INITIALIZED;
+    grid[b] |= MF_INITIALIZED;
+    ++joined;
+    gen_observe_carve(maze, x, y);
+    if (down)
+      gen_observe_carve(maze, x, y+1);
+    else
+      gen_observe_carve(maze, x+1, y);
+  }
+  free(edges);
+  free(parent);
+  free(rank);
+  return true;
+}
+
+/*
+ * Randomized Prim's algorithm
+ * */
+
+STAT_INLN void prim_add_frontier(u8 *grid, u32 *frontier, u32 *frontier_ct, int x, int y, int grid_width, int grid_height) {
+  int nx, ny;
+  for (int d = 0; d < 4; ++d) {
+    if (!gen_neighbour(x, y, GEN_DIRS[d], grid_width, grid_height, &nx, &ny))
+      continue;
+    u8 *cell = &grid[nx + ny*grid_width];
+    if (*cell&(MF_INITIALIZED|MF_FRONTIER))
+      continue;
+    *cell |= MF_FRONTIER;
+    frontier[(*frontier_ct)++] = PACK_COORD(nx, ny);
+  }
+}
+
+/**
+ * @brief Randomized Prim's algorithm. The frontier (cells adjacent to the
+ * maze but not in it) is a flat array; a random entry is swap-removed each
+ * step and joined to a random neighbour already in the maze. Working memory:
+ * one u32 per cell, allocated up front.
+ * */
+bool Prims_Algo(Maze_t *maze) {
+  u8 *grid = maze->grid;
+  const int grid_width = maze->width, grid_height = maze->height;
+  const u32 N = grid_width*grid_height;
+  u32 *frontier, frontier_ct = 0;
+  int x, y, nx, ny;
+  Grid_Reset(maze);
+  if (!(frontier = malloc(N*sizeof(u32))))
+    return false;
+
+  x = Rng_Range(&MAZE_RNG, grid_width);
+  y = Rng_Range(&MAZE_RNG, grid_height);
+  grid[x + y*grid_width] |= MF_INITIALIZED;
+  gen_observe_carve(maze, x, y);
+  prim_add_frontier(grid, frontier, &frontier_ct, x, y, grid_width, grid_height);
+
+  while (frontier_ct) {
+    u32 slot = Rng_Range(&MAZE_RNG, frontier_ct), cell = frontier[slot];
+    Direction_e in_maze[4];
+    u32 in_maze_cell[4];
+    int in_maze_ct = 0;
+    frontier[slot] = frontier[--frontier_ct];
+    x = PACKED_X(cell);
+    y = PACKED_Y(cell);
+    for (int d = 0; d < 4; ++d) {
+      if (!gen_neighbour(x, y, GEN_DIRS[d], grid_width, grid_height, &nx, &ny))
+        continue;
+      if (grid[nx + ny*grid_width]&MF_INITIALIZED) {
+        in_maze_cell[in_maze_ct] = PACK_COORD(nx, ny);
+        in_maze[in_maze_ct++] = GEN_DIRS[d];
+      }
+    }
+    assert(in_maze_ct!=0);
+    const int PICK = Rng_Range(&MAZE_RNG, in_maze_ct);
+    u32 idx = x + y*grid_width;
+    Grid_Carve_Idx(maze, idx, in_maze[PICK]);
+    grid[idx] = (grid[idx]&~MF_FRONTIER)|MF_INITIALIZED;
+    gen_observe_carve(maze, x, y);
+    gen_observe_carve(maze, PACKED_X(in_maze_cell[PICK]), PACKED_Y(in_maze_cell[PICK]));
+    prim_add_frontier(grid, frontier, &frontier_ct, x, y, grid_width, grid_height);
+  }
+  free(frontier);
+  return true;
+}
+
+/*
+ * Recursive backtracker
+ * */
+
+/**
+ * @brief Recursive backtracker (randomized depth-first search) with an
+ * explicit stack instead of recursion, so stack depth can't overflow the
+ * 32 KB of IWRAM on long corridors. Working memory: one u32 per cell,
+ * allocated up front.
+ * */
+bool Backtracker_Algo(Maze_t *maze) {
+  u8 *grid = maze->grid;
+  const int grid_width = maze->width, grid_height = maze->height;
+  const u32 N = grid_width*grid_height;
+  u32 *stack;
+  int top = -1, x, y, nx, ny;
+  Grid_Reset(maze);
+  if (!(stack = malloc(N*sizeof(u32))))
+    return false;
+
+  x = Rng_Range(&MAZE_RNG, grid_width);
+  y = Rng_Range(&MAZE_RNG, grid_height);
+  grid[x + y*grid_width] |= MF_INITIALIZED;
+  gen_observe_carve(maze, x, y);
+  stack[++top] = PACK_COORD(x, y);
+
+  while (-1 < top) {
+    Direction_e open[4];
+    u32 open_cell[4];
+    int open_ct = 0;
+    x = PACKED_X(stack[top]);
+    y = PACKED_Y(stack[top]);
+    for (int d = 0; d < 4; ++d) {
+      if (!gen_neighbour(x, y, GEN_DIRS[d], grid_width, grid_height, &nx, &ny))
+        continue;
+      if (!(grid[nx + ny*grid_width]&MF_INITIALIZED)) {
+        open_cell[open_ct] = PACK_COORD(nx, ny);
+        open[open_ct++] = GEN_DIRS[d];
+      }
+    }
+    if (!open_ct) {
+      --top;
+      continue;
+    }
+    const int PICK = Rng_Range(&MAZE_RNG, open_ct);
+    nx = PACKED_X(open_cell[PICK]);
+    ny = PACKED_Y(open_cell[PICK]);
+    Grid_Carve_Idx(maze, x + y*grid_width, open[PICK]);
+    grid[nx + ny*grid_width] |= MF_INITIALIZED;
+    gen_observe_carve(maze, x, y);
+    gen_observe_carve(maze, nx, ny);
+    stack[++top] = PACK_COORD(nx, ny);
+  }
+  free(stack);
+  return true;
+}
+
+/*
+ * Generator table
+ * */
+
+static bool gen_wilson_hybrid(Maze_t *maze) {
+  return Wilsons_Hybrid_Algo(maze, MAZE_HYBRID_AB_PERCENT);
+}
+
+const MazeGenerator_t MAZE_GENERATORS[MG_MAX] = {
+  [MG_WILSON] = {"Wilson", Wilsons_Algo},
+  [MG_WILSON_EXIT_ARROWS] = {"Wilson (exit arrows)", Wilsons_Algo_Exit_Arrows},
+  [MG_WILSON_HYBRID] = {"Aldous-Broder/Wilson", gen_wilson_hybrid},
+  [MG_ELLER] = {"Eller", Ellers_Algo},
+  [MG_KRUSKAL] = {"Kruskal", Kruskals_Algo},
+  [MG_PRIM] = {"Prim", Prims_Algo},
+  [MG_BACKTRACKER] = {"Backtracker", Backtracker_Algo},
+};
+
+/**
+ * @brief Carve a fresh maze into maze->grid with generator id, then pack its
+ * walls into maze->walls for the solver.
+ * */
+bool Maze_Generate(MazeGenId_e id, Maze_t *maze) {
+  if ((unsigned)id >= MG_MAX || !maze)
+    return false;
+  if (!MAZE_GENERATORS[id].generate(maze))
+    return false;
+  Maze_Walls_From_Grid(&maze->walls, maze->grid);
+  return true;
+}
+
+/**
+ * @brief Maze_Generate from a known RNG state: reseeds MAZE_RNG's maze stream
+ * with seed first and records seed and id in maze, so the same maze can be
+ * regenerated later from just those (see maze_save.h).
+ * */
+bool Maze_Generate_Seeded(MazeGenId_e id, Maze_t *maze, u32 seed) {
+  if (!maze)
+    return false;
+  Rng_Seed(&MAZE_RNG, seed, RNG_STREAM_MAZE);
+  maze->seed = seed;
+  maze->gen_id = id;
+  return Maze_Generate(id, maze);
+}
+
+/**
+ * @brief Run one generator and return the CPU cycles it took (observer
+ * included), or 0xFFFFFFFF if it failed. Uses timers 2 and 3.
+ * */
+u32 Maze_Generate_Timed(MazeGenId_e id, Maze_t *maze) {
+  u32 cycles;
+  Cycle_Timer_Start();
+  if (!Maze_Generate(id, maze))
+    return 0xFFFFFFFFUL;
+  cycles = Cycle_Timer_Read();
+  return cycles;
+}
+
+/**
+ * @brief Time every generator on the same maze, then print a table of cycle
+ * counts over the screen.
+ * */
+void Maze_Generator_Benchmark(Maze_t *maze) {
+  u32 cycles[MG_MAX];
+  for (int id = 0; id < MG_MAX; ++id) {
+    cycles[id] = Maze_Generate_Timed(id, maze);
+  }
+  mode3_clear_screen();
+  mode3_printf(0, 0, 0, "Generator cycles, %dx%d:\n", maze->width, maze->height);
+  for (int id = 0; id < MG_MAX; ++id) {
+    mode3_printf(0, (id+1)*8, 0, "%s\t\t%lu", MAZE_GENERATORS[id].name, (unsigned long)cycles[id]);
+  }
+}
@@ -0,0 +1,842 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_def.h"
+#include "gba_dma.h"
+#include "gba_funcs.h"
+#include "gba_mmap.h"
+#include "gba_types.h"
+#include "maze.h"
+#include "maze_render.h"
+#include "maze_walls.h"
+#include <stdlib.h>
+#include <assert.h>
+
+#define DCNT_MODE3_BG2 0x0403
+#define DCNT_MODE0_BG0 0x0100
+
+const MazeRenderer_t *MAZE_RENDERER = &MAZE_RENDERER_MODE3;
+// Starts out as what Render_Geometry_Init makes of Mode 3's 1x1 grid
+RenderGeometry_t MAZE_GEOMETRY = {
+  .grid_w = 1, .grid_h = 1, .cell_w = SCREEN_WIDTH, .cell_h = SCREEN_HEIGHT,
+  .hwall_len = SCREEN_WIDTH, .vwall_len = SCREEN_HEIGHT,
+  .right_ofs = SCREEN_WIDTH-1, .btm_ofs = SCREEN_HEIGHT-1,
+  .col_x = {0, SCREEN_WIDTH}, .row_y = {0, SCREEN_HEIGHT}, .row_cell = {0, 1}
+};
+// MAZE_RENDERER's snapshot of the clean maze, if it has one
+static void *clean_image = NULL;
+static u16 state_colors[RENDER_STATE_CT];
+
+/**
+ * @return the BGR555 color a cell drawn in color shows as, right now.
+ * */
+STAT_INLN u16 Render_Color(u32 color) {
+  if (color&RENDER_CELL_STATE)
+    return state_colors[color&(RENDER_STATE_CT-1)];
+  return color&0x7FFF;
+}
+
+void mode3_draw_line(Coord_t start, u32 color, int length, bool vertical) {
+  if (start.x < 0 || start.x >= SCREEN_WIDTH || start.y < 0 || start.y >= SCREEN_HEIGHT)
+    return;
+  if (length <= 0) return;
+
+  u16 *vr = VRAM_BUF + start.x + start.y*SCREEN_WIDTH;
+  if (vertical) {
+    if (start.y + length > SCREEN_HEIGHT)
+      return;
+    do {
+      *vr = color;
+      vr+= SCREEN_WIDTH;
+    } while (--length);
+  } else {
+    if (start.x + length > SCREEN_WIDTH)
+      return;
+    if (length >= DMA_FILL_MIN_SPAN) {
+      DMA_Fill_Span16(vr, color, length);
+      DMA_Fill_Submit();
+      return;
+    }
+    do {
+      *vr++ = color;
+    } while (--length);
+  }
+}
+
+/*
+ * mode3_draw_rect, but with DMA3 filling the rows once they're wide enough to
+ * be worth setting it up for.
+ * */
+static void Mode3_Fill_Rect(const BMP_Rect_t *r) {
+  if (r->width < DMA_FILL_MIN_SPAN) {
+    mode3_draw_rect(r);
+    return;
+  }
+  if (r->x < 0 || r->y < 0 || r->x + r->width > SCREEN_WIDTH || r->y + r->height > SCREEN_HEIGHT)
+    return;
+  DMA_Fill_Rect16(VRAM_BUF, SCREEN_WIDTH, r);
+  DMA_Fill_Submit();
+}
+
+static bool Mode3_Begin(int grid_width, int grid_height) {
+  if (grid_width > SCREEN_WIDTH || grid_height > SCREEN_HEIGHT)
+    return false;
+  REG_DISPLAY_CNT = DCNT_MODE3_BG2;
+  mode3_clear_screen();
+  return true;
+}
+
+static void Mode3_Draw_Cell_Walls(const RenderGeometry_t *geo, Coord_t rc, u8 cell) {
+  if (cell&MF_LEFT_WALL) {
+    mode3_draw_line(rc, MAZE_WALL_COLOR, geo->vwall_len, true);
+  }
+  if (cell&MF_RIGHT_WALL) {
+    mode3_draw_line(COORD(rc.x + geo->right_ofs, rc.y), MAZE_WALL_COLOR, geo->vwall_len, true);
+  }
+
+  if (cell&MF_TOP_WALL) {
+    mode3_draw_line(rc, MAZE_WALL_COLOR, geo->hwall_len, false);
+  }
+
+  if (cell&MF_BTM_WALL) {
+    mode3_draw_line(COORD(rc.x, rc.y + geo->btm_ofs), MAZE_WALL_COLOR, geo->hwall_len, false);
+  }
+}
+
+static void Mode3_Draw_Cell(const RenderGeometry_t *geo, Coord_t c, u8 cell, u32 color) {
+  if (c.x >= geo->grid_w || c.y >= geo->grid_h)
+    return;
+  BMP_Rect_t r = {
+    .x = geo->col_x[c.x], .y = geo->row_y[c.y], .width = geo->cell_w, .height = geo->cell_h,
+    .color = Render_Color(color)
+  };
+  if (color&RENDER_CELL_FILL) {
+    Mode3_Fill_Rect(&r);
+    return;
+  }
+  if (!(cell&MF_INITIALIZED)) {
+    r.color = 0;
+    Mode3_Fill_Rect(&r);
+    return;
+  }
+  Mode3_Fill_Rect(&r);
+  Mode3_Draw_Cell_Walls(geo, COORD(r.x, r.y), cell);
+}
+
+static void Mode3_Draw_Walls(const RenderGeometry_t *geo, const MazeWalls_t *walls, u32 color) {
+  // Every floor in one go, then just the walls over it
+  BMP_Rect_t r = {
+    .x = 0, .y = 0, .width = geo->col_x[geo->grid_w], .height = geo->row_y[geo->grid_h],
+    .color = Render_Color(color)
+  };
+  Mode3_Fill_Rect(&r);
+  for (int y = 0; y < walls->height; ++y) {
+    for (int x = 0; x < walls->width; ++x)
+      Mode3_Draw_Cell_Walls(geo, COORD(geo->col_x[x], geo->row_y[y]), Maze_Walls_Cell(walls, x, y));
+  }
+}
+
+static void *Mode3_Snapshot(void) {
+  u16 *image = malloc(SCREEN_WIDTH*SCREEN_HEIGHT*sizeof(u16));
+  if (image)
+    DMA3_Copy32(image, VRAM_BUF, SCREEN_WIDTH*SCREEN_HEIGHT/2);
+  return image;
+}
+
+static void Mode3_Restore(const RenderGeometry_t *geo, const void *image, int x, int y, int width, int height) {
+  const int LEFT = geo->col_x[x], TOP = geo->row_y[y];
+  const int ROWS = geo->row_y[y+height] - TOP, SPAN = geo->col_x[x+width] - LEFT;
+  const u16 *src = (const u16*)image + LEFT + TOP*SCREEN_WIDTH;
+  u16 *dst = VRAM_BUF + LEFT + TOP*SCREEN_WIDTH;
+  // Whole rows are one contiguous block
+  if (width==geo->grid_w) {
+    DMA3_Copy32(dst - LEFT, src - LEFT, ROWS*SCREEN_WIDTH/2);
+    return;
+  }
+  for (int h = ROWS; h--; src += SCREEN_WIDTH, dst += SCREEN_WIDTH) {
+    if (SPAN >= DMA_FILL_MIN_SPAN) {
+      DMA3_Copy16(dst, src, SPAN);
+      continue;
+    }
+    for (int i = 0; i < SPAN; ++i)
+      dst[i] = src[i];
+  }
+}
+
+const MazeRenderer_t MAZE_RENDERER_MODE3 = {
+  .name = "Mode 3",
+  .begin = Mode3_Begin,
+  .draw_cell = Mode3_Draw_Cell,
+  .draw_walls = Mode3_Draw_Walls,
+  .snapshot = Mode3_Snapshot,
+  .restore = Mode3_Restore,
+};
+
+/**
+ * @brief Mode 4 rect fill. rect->color is a palette index. Runs of four pixels
+ * go out as one 32-bit write, with halfword writes (read-modify-write for a
+ * lone pixel, since VRAM takes no byte writes) at the ragged edges. Wide rects
+ * have the word-aligned middle of each row filled by DMA3 instead.
+ * */
+void mode4_draw_rect(u16 *page, const BMP_Rect_t *rect) {
+  if (rect->x < 0 || rect->y < 0 || rect->x + rect->width > SCREEN_WIDTH
+      || rect->y + rect->height > SCREEN_HEIGHT)
+    return;
+  const u32 CLR = rect->color&0xFF, PAIR = CLR|(CLR<<8), QUAD = PAIR|(PAIR<<16);
+  const int END = rect->x + rect->width;
+  u8 *row = (u8*)page + rect->y*SCREEN_WIDTH;
+  for (u32 h = rect->height; h--; row += SCREEN_WIDTH) {
+    int x = rect->x;
+    if ((x&1) && x < END) {
+      u16 *px = (u16*)(row + x - 1);
+      *px = (*px&0x00FF)|(CLR<<8);
+      ++x;
+    }
+    if ((x&2) && x+2 <= END) {
+      *(u16*)(row + x) = PAIR;
+      x += 2;
+    }
+    if (END - x >= DMA_FILL_MIN_SPAN) {
+      const int WORDS = (END - x)>>2;
+      DMA_Fill_Push(row + x, QUAD, WORDS, true);
+      x += WORDS<<2;
+    }
+    for (; x+4 <= END; x += 4)
+      *(u32*)(row + x) = QUAD;
+    if (x+2 <= END) {
+      *(u16*)(row + x) = PAIR;
+      x += 2;
+    }
+    if (x < END) {
+      u16 *px = (u16*)(row + x);
+      *px = (*px&0xFF00)|CLR;
+    }
+  }
+  DMA_Fill_Submit();
+}
+
+void mode4_draw_line(u16 *page, Coord_t start, u8 clr_idx, int length, bool vertical) {
+  if (start.x < 0 || start.x >= SCREEN_WIDTH || start.y < 0 || start.y >= SCREEN_HEIGHT)
+    return;
+  if (length <= 0) return;
+  if (!vertical) {
+    BMP_Rect_t r = {.x = start.x, .y = start.y, .width = length, .height = 1, .color = clr_idx};
+    mode4_draw_rect(page, &r);
+    return;
+  }
+  if (start.y + length > SCREEN_HEIGHT)
+    return;
+  u16 *px = page + ((start.x + start.y*SCREEN_WIDTH)>>1);
+  const u16 MASK = (start.x&1) ? 0x00FF : 0xFF00, CLR = (start.x&1) ? clr_idx<<8 : clr_idx;
+  do {
+    *px = (*px&MASK)|CLR;
+    px += SCREEN_WIDTH>>1;
+  } while (--length);
+}
+
+#define DCNT_MODE4_BG2 0x0404
+#define DCNT_PAGE 0x0010
+// Mode 4 palette: 0 is black, 1 walls, the rest handed out to cell colors
+// and states
+#define MODE4_PAL_WALL 1
+#define MODE4_PAL_FIRST 2
+
+typedef struct s_mode4_op {
+  u8 x, y, cell;
+  u32 color;
+} Mode4Op_t;
+
+// Color (or RENDER_STATE) each palette index was handed out to
+static u32 mode4_colors[256];
+// Palette index of each state, 0 if it has none yet
+static u8 mode4_state_idx[RENDER_STATE_CT];
+static int mode4_color_ct = MODE4_PAL_FIRST, mode4_last_color = MODE4_PAL_FIRST;
+static int back_page = 1;
+static Mode4Op_t replay[MODE4_REPLAY_CT];
+static int replay_ct = 0;
+// Set when the back page got more than the ring holds, or a full redraw
+static bool replay_full = false;
+
+/**
+ * @return the palette index for color, claiming a free one if need be.
+ * Running out is a bug and asserts; without asserts, unknown colors then get
+ * the wall color's index.
+ * */
+STAT_INLN u8 Mode4_Color_Index(u32 color) {
+  color &= ~RENDER_CELL_FILL;
+  if (mode4_last_color < mode4_color_ct && mode4_colors[mode4_last_color]==color)
+    return mode4_last_color;
+  for (int i = MODE4_PAL_FIRST; i < mode4_color_ct; ++i) {
+    if (mode4_colors[i]==color)
+      return mode4_last_color = i;
+  }
+  assert(mode4_color_ct < 256);  // More distinct colors than palette entries
+  if (mode4_color_ct==256)
+    return MODE4_PAL_WALL;
+  if (color&RENDER_CELL_STATE)
+    mode4_state_idx[color&(RENDER_STATE_CT-1)] = mode4_color_ct;
+  mode4_colors[mode4_color_ct] = color;
+  PAL_BG_MEM[mode4_color_ct] = Render_Color(color);
+  return mode4_last_color = mode4_color_ct++;
+}
+
+static bool Mode4_Begin(int grid_width, int grid_height) {
+  if (grid_width > SCREEN_WIDTH || grid_height > SCREEN_HEIGHT)
+    return false;
+  mode4_color_ct = mode4_last_color = MODE4_PAL_FIRST;
+  for (int i = 0; i < RENDER_STATE_CT; ++i)
+    mode4_state_idx[i] = 0;
+  PAL_BG_MEM[0] = 0;
+  PAL_BG_MEM[MODE4_PAL_WALL] = MAZE_WALL_COLOR;
+  DMA3_Fill32(VRAM_PAGE(0), 0, 2*MODE4_PAGE_SIZE/4);
+  replay_ct = 0;
+  replay_full = false;
+  back_page = 1;
+  REG_DISPLAY_CNT = DCNT_MODE4_BG2;
+  return true;
+}
+
+static void Mode4_Render_Cell_Walls(u16 *page, const RenderGeometry_t *geo, Coord_t rc, u8 cell) {
+  if (cell&MF_LEFT_WALL)
+    mode4_draw_line(page, rc, MODE4_PAL_WALL, geo->vwall_len, true);
+  if (cell&MF_RIGHT_WALL)
+    mode4_draw_line(page, COORD(rc.x + geo->right_ofs, rc.y), MODE4_PAL_WALL, geo->vwall_len, true);
+  if (cell&MF_TOP_WALL)
+    mode4_draw_line(page, rc, MODE4_PAL_WALL, geo->hwall_len, false);
+  if (cell&MF_BTM_WALL)
+    mode4_draw_line(page, COORD(rc.x, rc.y + geo->btm_ofs), MODE4_PAL_WALL, geo->hwall_len, false);
+}
+
+static void Mode4_Render_Cell(u16 *page, const RenderGeometry_t *geo, Coord_t c, u8 cell, u32 color) {
+  BMP_Rect_t r = {
+    .x = geo->col_x[c.x], .y = geo->row_y[c.y], .width = geo->cell_w, .height = geo->cell_h,
+    .color = 0
+  };
+  if (color&RENDER_CELL_FILL) {
+    r.color = Mode4_Color_Index(color);
+    mode4_draw_rect(page, &r);
+    return;
+  }
+  if (!(cell&MF_INITIALIZED)) {
+    mode4_draw_rect(page, &r);
+    return;
+  }
+  r.color = Mode4_Color_Index(color);
+  mode4_draw_rect(page, &r);
+  Mode4_Render_Cell_Walls(page, geo, COORD(r.x, r.y), cell);
+}
+
+static void Mode4_Draw_Cell(const RenderGeometry_t *geo, Coord_t c, u8 cell, u32 color) {
+  if (c.x >= geo->grid_w || c.y >= geo->grid_h)
+    return;
+  Mode4_Render_Cell(VRAM_PAGE(back_page), geo, c, cell, color);
+  if (replay_full)
+    return;
+  if (replay_ct==MODE4_REPLAY_CT) {
+    replay_full = true;
+    return;
+  }
+  replay[replay_ct++] = (Mode4Op_t){.x = c.x, .y = c.y, .cell = cell, .color = color};
+}
+
+static void Mode4_Draw_Walls(const RenderGeometry_t *geo, const MazeWalls_t *walls, u32 color) {
+  u16 *page = VRAM_PAGE(back_page);
+  // Every floor in one go, then just the walls over it
+  BMP_Rect_t r = {
+    .x = 0, .y = 0, .width = geo->col_x[geo->grid_w], .height = geo->row_y[geo->grid_h],
+    .color = Mode4_Color_Index(color)
+  };
+  mode4_draw_rect(page, &r);
+  for (int y = 0; y < walls->height; ++y) {
+    for (int x = 0; x < walls->width; ++x)
+      Mode4_Render_Cell_Walls(page, geo, COORD(geo->col_x[x], geo->row_y[y]), Maze_Walls_Cell(walls, x, y));
+  }
+  replay_full = true;
+}
+
+/**
+ * @brief Flip to the page drawn since the last flip, then bring the new back
+ * page up to date with it. Does nothing if nothing was drawn.
+ * */
+static void Mode4_Present(void) {
+  if (!replay_ct && !replay_full)
+    return;
+  REG_DISPLAY_CNT ^= DCNT_PAGE;
+  u16 *front = VRAM_PAGE(back_page), *back = VRAM_PAGE(back_page ^= 1);
+  if (replay_full) {
+    DMA3_Copy32(back, front, MODE4_PAGE_SIZE/4);
+  } else {
+    for (int i = 0; i < replay_ct; ++i)
+      Mode4_Render_Cell(back, &MAZE_GEOMETRY, COORD(replay[i].x, replay[i].y), replay[i].cell, replay[i].color);
+  }
+  replay_ct = 0;
+  replay_full = false;
+}
+
+/*
+ * The back page is always the newest image, and the front page catches up to
+ * it at the next flip, so snapshots come from and restores go to the back
+ * page.
+ * */
+static void *Mode4_Snapshot(void) {
+  u16 *image = malloc(SCREEN_WIDTH*SCREEN_HEIGHT);
+  if (image)
+    DMA3_Copy32(image, VRAM_PAGE(back_page), SCREEN_WIDTH*SCREEN_HEIGHT/4);
+  return image;
+}
+
+static void Mode4_Restore(const RenderGeometry_t *geo, const void *image, int x, int y, int width, int height) {
+  const int OFS = geo->row_y[y]*SCREEN_WIDTH, ROWS = geo->row_y[y+height] - geo->row_y[y];
+  const int START = geo->col_x[x], END = geo->col_x[x+width];
+  const u8 *src = (const u8*)image + OFS;
+  u8 *dst = (u8*)VRAM_PAGE(back_page) + OFS;
+  // The front page gets the restored cells by way of the full-page copy
+  replay_full = true;
+  if (width==geo->grid_w) {
+    DMA3_Copy32(dst, src, ROWS*SCREEN_WIDTH/4);
+    return;
+  }
+  for (int h = ROWS; h--; src += SCREEN_WIDTH, dst += SCREEN_WIDTH) {
+    int x0 = START, x1 = END;
+    // No byte writes to VRAM: odd ends are read-modify-write halfwords
+    if (x0&1) {
+      u16 *px = (u16*)(dst + x0 - 1);
+      *px = (*px&0x00FF)|(src[x0]<<8);
+      ++x0;
+    }
+    if ((x1&1) && x0 < x1) {
+      u16 *px = (u16*)(dst + x1 - 1);
+      *px = (*px&0xFF00)|src[x1-1];
+      --x1;
+    }
+    if (x0 < x1)
+      DMA3_Copy16(dst + x0, src + x0, (x1 - x0)>>1);
+  }
+}
+
+static void Mode4_Set_State_Color(int state, u16 color) {
+  if (mode4_state_idx[state])
+    PAL_BG_MEM[mode4_state_idx[state]] = color;
+}
+
+const MazeRenderer_t MAZE_RENDERER_MODE4 = {
+  .name = "Mode 4",
+  .begin = Mode4_Begin,
+  .draw_cell = Mode4_Draw_Cell,
+  .draw_walls = Mode4_Draw_Walls,
+  .present = Mode4_Present,
+  .snapshot = Mode4_Snapshot,
+  .restore = Mode4_Restore,
+  .set_state_color = Mode4_Set_State_Color,
+};
+
+/*
+ * Tiled renderer. Charblock TILED_CBB holds:
+ *   tile 0: blank (backdrop), for cells not in the maze yet
+ *   tiles 1-16: TILE_WALLS + a cell's MF wall nibble
+ *   tile 17: solid floor, for RENDER_CELL_FILL
+ * Every tile uses palette index 1 for floor and 2 for wall. Bank b's floor
+ * color is whichever cell color or state got bank b first (see
+ * Tiled_Color_Bank).
+ *
+ * Every cell's screen entry lives in tiled_cells, whatever the maze size.
+ * The BG map is a 64x64 ring over it: cell (x, y) goes to map slot
+ * (x%64, y%64), and only cells in view are ever written there. Scrolling
+ * moves the BG offset and copies in just the rows and columns that came
+ * into view.
+ * */
+#define TILE_BLANK 0
+#define TILE_WALLS 1
+#define TILE_SOLID 17
+#define PAL_FLOOR 1
+#define PAL_WALL 2
+#define TILED_CELL_PX 8
+// A view's worth of cells, counting the partly scrolled-in one
+#define TILED_VIEW_W (SCREEN_WIDTH/TILED_CELL_PX + 1)
+#define TILED_VIEW_H (SCREEN_HEIGHT/TILED_CELL_PX + 1)
+
+static u32 bank_colors[16];
+static int bank_ct = 0, last_bank = 0;
+// Palette bank of each state, plus one; 0 if it has none yet
+static u8 state_banks[RENDER_STATE_CT];
+static u16 *tiled_cells = NULL;
+static int tiled_w = 0, tiled_h = 0;
+// Top left pixel of the view, and the cells it covers
+static int view_x = 0, view_y = 0;
+static int view_cx0 = 0, view_cy0 = 0, view_cx1 = 0, view_cy1 = 0;
+
+STAT_INLN u32 Tile_Row(u8 walls, int y) {
+  u32 row = 0;
+  for (int x = 0; x < 8; ++x) {
+    bool wall = ((walls&MF_LEFT_WALL) && x==0) || ((walls&MF_RIGHT_WALL) && x==7)
+      || ((walls&MF_TOP_WALL) && y==0) || ((walls&MF_BTM_WALL) && y==7);
+    row |= (wall ? PAL_WALL : PAL_FLOOR)<<(x<<2);
+  }
+  return row;
+}
+
+/**
+ * @return the palette bank whose floor color is color, claiming a free bank
+ * for it if there isn't one. Running out is a bug and asserts, as main
+ * already claims 14 of the 16; without asserts, unknown colors then get
+ * bank 0.
+ * */
+STAT_INLN int Tiled_Color_Bank(u32 color) {
+  color &= ~RENDER_CELL_FILL;
+  if (bank_ct && bank_colors[last_bank]==color)
+    return last_bank;
+  for (int i = 0; i < bank_ct; ++i) {
+    if (bank_colors[i]==color)
+      return last_bank = i;
+  }
+  assert(bank_ct < 16);  // More distinct colors than palette banks
+  if (bank_ct==16)
+    return 0;
+  if (color&RENDER_CELL_STATE)
+    state_banks[color&(RENDER_STATE_CT-1)] = bank_ct+1;
+  bank_colors[bank_ct] = color;
+  PAL_BG_MEM[(bank_ct<<4) + PAL_FLOOR] = Render_Color(color);
+  PAL_BG_MEM[(bank_ct<<4) + PAL_WALL] = MAZE_WALL_COLOR;
+  return last_bank = bank_ct++;
+}
+
+STAT_INLN u16 *Tiled_Screen_Entry(int x, int y) {
+  x &= TILED_MAP_MAX-1;
+  y &= TILED_MAP_MAX-1;
+  return SE_MEM[TILED_SBB + (x>>5) + ((y>>5)<<1)] + (x&31) + ((y&31)<<5);
+}
+
+STAT_INLN u16 Tiled_Entry(u8 cell, u32 color) {
+  u16 tile;
+  if (color&RENDER_CELL_FILL)
+    tile = TILE_SOLID;
+  else if (!(cell&MF_INITIALIZED))
+    return TILE_BLANK;
+  else
+    tile = TILE_WALLS + (cell&15);
+  return tile | (Tiled_Color_Bank(color)<<12);
+}
+
+STAT_INLN bool Tiled_In_View(int x, int y) {
+  return x >= view_cx0 && x <= view_cx1 && y >= view_cy0 && y <= view_cy1;
+}
+
+/**
+ * @brief Copy cells x0..x1 of row y from tiled_cells into the map.
+ * */
+static void Tiled_Stream_Row(int y, int x0, int x1) {
+  const u16 *src = tiled_cells + y*tiled_w;
+  for (int x = x0; x <= x1; ++x)
+    *Tiled_Screen_Entry(x, y) = src[x];
+}
+
+/**
+ * @brief Point the view's top left at pixel (x, y), clamped to the maze, and
+ * bring the map up to date for it. Takes effect on screen at the next
+ * present.
+ * */
+static void Tiled_Set_View(int x, int y) {
+  const int OX0 = view_cx0, OY0 = view_cy0, OX1 = view_cx1, OY1 = view_cy1;
+  const int MAX_X = tiled_w*TILED_CELL_PX - SCREEN_WIDTH, MAX_Y = tiled_h*TILED_CELL_PX - SCREEN_HEIGHT;
+  view_x = x > MAX_X ? MAX_X : x;
+  view_y = y > MAX_Y ? MAX_Y : y;
+  if (view_x < 0)
+    view_x = 0;
+  if (view_y < 0)
+    view_y = 0;
+  view_cx0 = view_x/TILED_CELL_PX;
+  view_cy0 = view_y/TILED_CELL_PX;
+  view_cx1 = view_cx0 + TILED_VIEW_W-1;
+  view_cy1 = view_cy0 + TILED_VIEW_H-1;
+  if (view_cx1 >= tiled_w)
+    view_cx1 = tiled_w-1;
+  if (view_cy1 >= tiled_h)
+    view_cy1 = tiled_h-1;
+  for (int cy = view_cy0; cy <= view_cy1; ++cy) {
+    if (cy < OY0 || cy > OY1) {
+      Tiled_Stream_Row(cy, view_cx0, view_cx1);
+      continue;
+    }
+    if (view_cx0 < OX0)
+      Tiled_Stream_Row(cy, view_cx0, view_cx1 < OX0 ? view_cx1 : OX0-1);
+    if (view_cx1 > OX1)
+      Tiled_Stream_Row(cy, view_cx0 > OX1 ? view_cx0 : OX1+1, view_cx1);
+  }
+}
+
+/**
+ * @brief Redraw every cell in view from tiled_cells.
+ * */
+static void Tiled_Stream_View(void) {
+  for (int cy = view_cy0; cy <= view_cy1; ++cy)
+    Tiled_Stream_Row(cy, view_cx0, view_cx1);
+}
+
+static void Tiled_End(void) {
+  free(tiled_cells);
+  tiled_cells = NULL;
+}
+
+static bool Tiled_Begin(int grid_width, int grid_height) {
+  Tile *tiles = TILE_MEM[TILED_CBB];
+  Tiled_End();
+  if (!(tiled_cells = malloc(grid_width*grid_height*sizeof(u16))))
+    return false;
+  tiled_w = grid_width;
+  tiled_h = grid_height;
+  for (int i = 0; i < grid_width*grid_height; ++i)
+    tiled_cells[i] = TILE_BLANK;
+  fast_memset32(tiles[TILE_BLANK], 0, sizeof(Tile)/4);
+  for (u8 walls = 0; walls < 16; ++walls) {
+    for (int y = 0; y < 8; ++y)
+      tiles[TILE_WALLS + walls][y] = Tile_Row(walls, y);
+  }
+  fast_memset32(tiles[TILE_SOLID], 0x11111111U*PAL_FLOOR, sizeof(Tile)/4);
+
+  DMA3_Fill32(SE_MEM[TILED_SBB], TILE_BLANK, 4*sizeof(Screenblock)/4);
+  // Whole map is blank, so there's nothing to stream for the first view
+  view_cx0 = view_cy0 = 0;
+  view_cx1 = view_cy1 = TILED_MAP_MAX;
+  Tiled_Set_View(0, 0);
+  bank_ct = last_bank = 0;
+  for (int i = 0; i < RENDER_STATE_CT; ++i)
+    state_banks[i] = 0;
+  PAL_BG_MEM[0] = 0;
+  // 512x512 px map, four screenblocks, at priority 1 so the HUD on BG1
+  // draws over it
+  REG_BG_CNT(0) = (TILED_CBB<<2) | (TILED_SBB<<8) | (3<<14) | 1;
+  REG_BG_HOFS(0) = 0;
+  REG_BG_VOFS(0) = 0;
+  REG_DISPLAY_CNT = DCNT_MODE0_BG0;
+  return true;
+}
+
+static void Tiled_Draw_Cell(const RenderGeometry_t *geo, Coord_t c, u8 cell, u32 color) {
+  if (c.x >= tiled_w || c.y >= tiled_h)
+    return;
+  const u16 ENTRY = Tiled_Entry(cell, color);
+  tiled_cells[geo->row_cell[c.y] + c.x] = ENTRY;
+  if (Tiled_In_View(c.x, c.y))
+    *Tiled_Screen_Entry(c.x, c.y) = ENTRY;
+}
+
+static void Tiled_Draw_Walls(const RenderGeometry_t *geo, const MazeWalls_t *walls, u32 color) {
+  const u16 BANK = Tiled_Color_Bank(color)<<12;
+  u16 *entry = tiled_cells;
+  (void)geo;
+  for (int y = 0; y < walls->height; ++y) {
+    for (int x = 0; x < walls->width; ++x)
+      *entry++ = (TILE_WALLS + Maze_Walls_Cell(walls, x, y)) | BANK;
+  }
+  Tiled_Stream_View();
+}
+
+static void Tiled_Present(void) {
+  REG_BG_HOFS(0) = view_x;
+  REG_BG_VOFS(0) = view_y;
+}
+
+/**
+ * @brief Scroll just far enough to keep cell at least TILED_FOLLOW_MARGIN
+ * pixels in from every edge of the screen.
+ * @return top left pixel of the view.
+ * */
+static Coord_t Tiled_Follow(Coord_t cell) {
+  const int X = cell.x*TILED_CELL_PX, Y = cell.y*TILED_CELL_PX;
+  int x = view_x, y = view_y;
+  if (X - x < TILED_FOLLOW_MARGIN)
+    x = X - TILED_FOLLOW_MARGIN;
+  else if (X + TILED_CELL_PX - x > SCREEN_WIDTH - TILED_FOLLOW_MARGIN)
+    x = X + TILED_CELL_PX + TILED_FOLLOW_MARGIN - SCREEN_WIDTH;
+  if (Y - y < TILED_FOLLOW_MARGIN)
+    y = Y - TILED_FOLLOW_MARGIN;
+  else if (Y + TILED_CELL_PX - y > SCREEN_HEIGHT - TILED_FOLLOW_MARGIN)
+    y = Y + TILED_CELL_PX + TILED_FOLLOW_MARGIN - SCREEN_HEIGHT;
+  if (x!=view_x || y!=view_y)
+    Tiled_Set_View(x, y);
+  return COORD(view_x, view_y);
+}
+
+/*
+ * Palette banks are never given back short of Tiled_Begin, so the snapshot's
+ * screen entries stay valid as they are.
+ * */
+static void *Tiled_Snapshot(void) {
+  u16 *image = malloc(tiled_w*tiled_h*sizeof(u16));
+  if (image)
+    DMA3_Copy16(image, tiled_cells, tiled_w*tiled_h);
+  return image;
+}
+
+static void Tiled_Restore(const RenderGeometry_t *geo, const void *image, int x, int y, int width, int height) {
+  const u16 *src = image;
+  if (width==tiled_w && height==tiled_h) {
+    DMA3_Copy16(tiled_cells, image, tiled_w*tiled_h);
+    Tiled_Stream_View();
+    return;
+  }
+  for (int cy = y; cy < y+height; ++cy) {
+    const int ROW = geo->row_cell[cy];
+    for (int cx = x; cx < x+width; ++cx) {
+      tiled_cells[ROW + cx] = src[ROW + cx];
+      if (Tiled_In_View(cx, cy))
+        *Tiled_Screen_Entry(cx, cy) = src[ROW + cx];
+    }
+  }
+}
+
+static void Tiled_Set_State_Color(int state, u16 color) {
+  if (state_banks[state])
+    PAL_BG_MEM[((state_banks[state]-1)<<4) + PAL_FLOOR] = color;
+}
+
+const MazeRenderer_t MAZE_RENDERER_TILED = {
+  .name = "Mode 0 tiles",
+  .cell_px = TILED_CELL_PX,
+  .begin = Tiled_Begin,
+  .end = Tiled_End,
+  .draw_cell = Tiled_Draw_Cell,
+  .draw_walls = Tiled_Draw_Walls,
+  .present = Tiled_Present,
+  .snapshot = Tiled_Snapshot,
+  .restore = Tiled_Restore,
+  .set_state_color = Tiled_Set_State_Color,
+  .follow = Tiled_Follow,
+};
+
+/**
+ * @brief Switch to renderer, set up for a grid_width x grid_height maze.
+ * @return false (leaving the current renderer in place) if renderer can't
+ * show a maze that size.
+ * */
+bool Maze_Renderer_Use(const MazeRenderer_t *renderer, int grid_width, int grid_height) {
+  if (!renderer->begin(grid_width, grid_height))
+    return false;
+  Maze_Renderer_Drop_Snapshot();
+  if (MAZE_RENDERER!=renderer && MAZE_RENDERER->end)
+    MAZE_RENDERER->end();
+  MAZE_RENDERER = renderer;
+  Render_Geometry_Init(&MAZE_GEOMETRY, grid_width, grid_height, renderer->cell_px);
+  return true;
+}
+
+/**
+ * @brief Back to a blank Mode 3 screen (for text), if not there already.
+ * */
+void Maze_Renderer_Release(void) {
+  Maze_Renderer_Drop_Snapshot();
+  if (MAZE_RENDERER==&MAZE_RENDERER_MODE3)
+    return;
+  Maze_Renderer_Use(&MAZE_RENDERER_MODE3, 1, 1);
+}
+
+/**
+ * @brief Keep a copy of what's drawn now, normally the maze with nothing over
+ * it, for the restore functions. Replaces any snapshot taken before.
+ * @return false if the renderer can't snapshot or there's no memory for it.
+ * */
+bool Maze_Renderer_Snapshot(void) {
+  Maze_Renderer_Drop_Snapshot();
+  if (MAZE_RENDERER->snapshot)
+    clean_image = MAZE_RENDERER->snapshot();
+  return clean_image!=NULL;
+}
+
+void Maze_Renderer_Drop_Snapshot(void) {
+  free(clean_image);
+  clean_image = NULL;
+}
+
+/**
+ * @brief Put the snapshot back over the width x height cells at (x, y),
+ * clipped to the grid. Shows at the next present, like any other drawing.
+ * @return false if there's no snapshot to restore from.
+ * */
+bool Maze_Renderer_Restore_Cells(int x, int y, int width, int height) {
+  if (!clean_image)
+    return false;
+  if (x < 0) {
+    width += x;
+    x = 0;
+  }
+  if (y < 0) {
+    height += y;
+    y = 0;
+  }
+  if (x + width > MAZE_GEOMETRY.grid_w)
+    width = MAZE_GEOMETRY.grid_w - x;
+  if (y + height > MAZE_GEOMETRY.grid_h)
+    height = MAZE_GEOMETRY.grid_h - y;
+  if (width > 0 && height > 0)
+    MAZE_RENDERER->restore(&MAZE_GEOMETRY, clean_image, x, y, width, height);
+  return true;
+}
+
+bool Maze_Renderer_Restore(void) {
+  return Maze_Renderer_Restore_Cells(0, 0, MAZE_GEOMETRY.grid_w, MAZE_GEOMETRY.grid_h);
+}
+
+/**
+ * @brief Set what cells drawn in RENDER_STATE(state) look like. Palette
+ * renderers recolor every such cell already drawn with a single palette
+ * write; Mode 3 only uses it for cells drawn from now on.
+ * @return true if cells already drawn changed color too.
+ * */
+bool Maze_Renderer_Set_State_Color(int state, u16 color) {
+  state &= RENDER_STATE_CT-1;
+  state_colors[state] = color&0x7FFF;
+  if (!MAZE_RENDERER->set_state_color)
+    return false;
+  MAZE_RENDERER->set_state_color(state, color&0x7FFF);
+  return true;
+}
+
+u16 Maze_Renderer_State_Color(int state) {
+  return state_colors[state&(RENDER_STATE_CT-1)];
+}
+
+/**
+ * @brief Rotate the colors of states [first, first+count) by one, e.g. for a
+ * path drawn in those states in turn to look like it's moving. count palette
+ * writes, however many cells are in those states.
+ * */
+void Maze_Renderer_Cycle_States(int first, int count) {
+  if (count < 2 || first < 0 || first + count > RENDER_STATE_CT)
+    return;
+  const u16 LAST = state_colors[first + count-1];
+  for (int i = first + count-1; i > first; --i)
+    Maze_Renderer_Set_State_Color(i, state_colors[i-1]);
+  Maze_Renderer_Set_State_Color(first, LAST);
+}
+
+/**
+ * @return size of a cell on screen, in pixels.
+ * */
+Coord_t Maze_Renderer_Cell_Size(void) {
+  return COORD(MAZE_GEOMETRY.cell_w, MAZE_GEOMETRY.cell_h);
+}
+
+/**
+ * @brief Keep cell in view, for renderers that show only part of the maze,
+ * and move the sprite overlay along with the view.
+ * */
+void Maze_Renderer_Follow(Coord_t cell) {
+  if (!MAZE_RENDERER->follow)
+    return;
+  Sprite_Overlay_Set_Origin(MAZE_RENDERER->follow(cell));
+}
+
+void draw_maze_cell(const Maze_t *maze, const Coord_t *coord, u32 color) {
+  Coord_t c = *coord;
+  if (c.x < 0 || c.y < 0 || c.x >= maze->width || c.y >= maze->height)
+    return;
+  MAZE_RENDERER->draw_cell(&MAZE_GEOMETRY, c, maze->grid[CIDX(c, maze->width)], color);
+}
+
+void draw_maze_walls_cell(const MazeWalls_t *walls, const Coord_t *coord, u32 color) {
+  Coord_t c = *coord;
+  if (c.x < 0 || c.y < 0 || c.x >= walls->width || c.y >= walls->height)
+    return;
+  MAZE_RENDERER->draw_cell(&MAZE_GEOMETRY, c, MF_INITIALIZED|Maze_Walls_Cell(walls, c.x, c.y), color);
+}
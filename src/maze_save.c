@@ -0,0 +1,345 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_funcs.h"
+#include "gba_types.h"
+#include "maze.h"
+#include "maze_save.h"
+#include "maze_walls.h"
+
+#define SAVE_INDEX_OFS sizeof(MazeSaveHeader_t)
+#define SAVE_DATA_OFS (SAVE_INDEX_OFS + MAZE_SAVE_SLOT_CT*sizeof(MazeSaveEntry_t))
+// SRAM_Write rejects any write reaching offset 0x10000, so the last byte is
+// never handed out
+#define SAVE_DATA_END 0xFFFFUL
+#define SAVE_CHUNK 64
+
+// RAM copy of the header and index, so lookups never touch SRAM
+static MazeSaveHeader_t header;
+static MazeSaveEntry_t entries[MAZE_SAVE_SLOT_CT];
+static bool ready = false;
+
+/*
+ * Chunked SRAM reader/writer for the packed format, keeping a running
+ * Fletcher-16 of every byte that passes through it. The sums are only reduced
+ * mod 255 once a chunk, by folding rather than dividing; a chunk's worth of
+ * bytes can't overflow them in between.
+ * */
+typedef struct s_save_stream {
+  u8 buf[SAVE_CHUNK];
+  u32 ofs, fill, pos, left;
+  u32 s1, s2;
+} SaveStream_t;
+
+/**
+ * @return s mod 255, using 256 = 1 (mod 255) and the same of 65536.
+ * */
+STAT_INLN u32 Save_Fold(u32 s) {
+  s = (s&0xFFFF) + (s>>16);
+  s = (s&0xFF) + (s>>8);
+  s = (s&0xFF) + (s>>8);
+  return s >= 255 ? s-255 : s;
+}
+
+STAT_INLN void Save_Stream_Sum(SaveStream_t *stream, u8 byte) {
+  stream->s1 += byte;
+  stream->s2 += stream->s1;
+}
+
+STAT_INLN void Save_Stream_Reduce(SaveStream_t *stream) {
+  stream->s1 = Save_Fold(stream->s1);
+  stream->s2 = Save_Fold(stream->s2);
+}
+
+STAT_INLN u16 Save_Stream_Checksum(const SaveStream_t *stream) {
+  return (Save_Fold(stream->s2)<<8)|Save_Fold(stream->s1);
+}
+
+static bool Save_Stream_Flush(SaveStream_t *stream) {
+  Save_Stream_Reduce(stream);
+  if (!stream->fill)
+    return true;
+  if (!SRAM_Write(stream->buf, stream->fill, stream->ofs))
+    return false;
+  stream->ofs += stream->fill;
+  stream->fill = 0;
+  return true;
+}
+
+static bool Save_Stream_Put(SaveStream_t *stream, u8 byte) {
+  Save_Stream_Sum(stream, byte);
+  stream->buf[stream->fill++] = byte;
+  return stream->fill < SAVE_CHUNK || Save_Stream_Flush(stream);
+}
+
+static bool Save_Stream_Get(SaveStream_t *stream, u8 *byte) {
+  if (stream->pos==stream->fill) {
+    if (!stream->left)
+      return false;
+    Save_Stream_Reduce(stream);
+    stream->fill = stream->left < SAVE_CHUNK ? stream->left : SAVE_CHUNK;
+    if (!SRAM_Read(stream->buf, stream->fill, stream->ofs))
+      return false;
+    stream->ofs += stream->fill;
+    stream->left -= stream->fill;
+    stream->pos = 0;
+  }
+  *byte = stream->buf[stream->pos++];
+  Save_Stream_Sum(stream, *byte);
+  return true;
+}
+
+STAT_INLN u32 Packed_Size(int width, int height) {
+  return ((u32)width*height + 3)>>2;
+}
+
+static bool Save_Write_Index(void) {
+  // Index first, header last: a store cut short leaves the old header, which
+  // doesn't reference the new entry yet
+  if (header.entry_ct && !SRAM_Write(entries, header.entry_ct*sizeof(MazeSaveEntry_t), SAVE_INDEX_OFS))
+    return false;
+  return SRAM_Write(&header, sizeof(header), 0);
+}
+
+/**
+ * @brief Wipe every stored maze and write a fresh header.
+ * */
+void Maze_Save_Clear(void) {
+  header = (MazeSaveHeader_t){.magic = MAZE_SAVE_MAGIC, .entry_ct = 0, .data_end = SAVE_DATA_OFS};
+  ready = SRAM_Write(&header, sizeof(header), 0);
+}
+
+/**
+ * @brief Load the index from SRAM, formatting the save area if it holds
+ * anything other than a valid maze index.
+ * @return false if SRAM couldn't be read or written.
+ * */
+bool Maze_Save_Init(void) {
+  ready = false;
+  if (!SRAM_Read(&header, sizeof(header), 0))
+    return false;
+  // data_end is a u16, so it can't run past SAVE_DATA_END
+  if (header.magic!=MAZE_SAVE_MAGIC || header.entry_ct > MAZE_SAVE_SLOT_CT
+      || header.data_end < SAVE_DATA_OFS) {
+    Maze_Save_Clear();
+    return ready;
+  }
+  if (header.entry_ct && !SRAM_Read(entries, header.entry_ct*sizeof(MazeSaveEntry_t), SAVE_INDEX_OFS))
+    return false;
+  // Drop entries whose data isn't inside the data area, rather than ever
+  // reading or compacting bytes that aren't theirs
+  int kept = 0;
+  for (int i = 0; i < header.entry_ct; ++i) {
+    if (entries[i].data_ofs < SAVE_DATA_OFS
+        || entries[i].data_ofs + (u32)entries[i].data_len > header.data_end)
+      continue;
+    entries[kept++] = entries[i];
+  }
+  if (kept!=header.entry_ct) {
+    header.entry_ct = kept;
+    if (!Save_Write_Index())
+      return false;
+  }
+  ready = true;
+  return true;
+}
+
+int Maze_Save_Count(void) {
+  return ready ? header.entry_ct : 0;
+}
+
+bool Maze_Save_Get_Entry(int slot, MazeSaveEntry_t *entry) {
+  if (!ready || slot < 0 || slot >= header.entry_ct || !entry)
+    return false;
+  *entry = entries[slot];
+  return true;
+}
+
+/**
+ * @brief Most recently stored maze of the given size.
+ * @return its slot, or -1 if there is none.
+ * */
+int Maze_Save_Find(int width, int height) {
+  for (int slot = Maze_Save_Count(); slot--;) {
+    if (entries[slot].width==width && entries[slot].height==height)
+      return slot;
+  }
+  return -1;
+}
+
+/**
+ * @brief Store maze in the given format. MSF_SEED needs the maze to have been
+ * made by Maze_Generate_Seeded.
+ * @return the new slot, or -1 if the index or data area is full, the maze
+ * wasn't seeded (MSF_SEED), or the write failed.
+ * */
+int Maze_Save_Store(const Maze_t *maze, MazeSaveFormat_e format) {
+  MazeSaveEntry_t entry;
+  if (!ready || !maze || header.entry_ct >= MAZE_SAVE_SLOT_CT)
+    return -1;
+  entry = (MazeSaveEntry_t){
+    .seed = maze->seed, .data_ofs = header.data_end, .data_len = 0,
+    .width = maze->width, .height = maze->height,
+    .format = format, .gen_id = maze->gen_id, .checksum = 0
+  };
+  switch (format) {
+  case MSF_SEED:
+    if ((unsigned)maze->gen_id >= MG_MAX)
+      return -1;
+    break;
+  case MSF_PACKED: {
+    const MazeWalls_t *walls = &maze->walls;
+    SaveStream_t stream = {.ofs = header.data_end};
+    u32 cell = 0;
+    u8 byte = 0;
+    entry.data_len = Packed_Size(maze->width, maze->height);
+    if (header.data_end + (u32)entry.data_len > SAVE_DATA_END)
+      return -1;
+    for (int y = 0; y < maze->height; ++y) {
+      for (int x = 0; x < maze->width; ++x) {
+        byte |= (Maze_Walls_Right(walls, x, y) | (Maze_Walls_Bottom(walls, x, y)<<1))<<((cell&3)<<1);
+        if (!(++cell&3)) {
+          if (!Save_Stream_Put(&stream, byte))
+            return -1;
+          byte = 0;
+        }
+      }
+    }
+    if ((cell&3) && !Save_Stream_Put(&stream, byte))
+      return -1;
+    if (!Save_Stream_Flush(&stream))
+      return -1;
+    entry.checksum = Save_Stream_Checksum(&stream);
+    break;
+  }
+  default:
+    return -1;
+  }
+  entries[header.entry_ct++] = entry;
+  header.data_end += entry.data_len;
+  if (!Save_Write_Index()) {
+    header.data_end -= entry.data_len;
+    --header.entry_ct;
+    return -1;
+  }
+  return header.entry_ct-1;
+}
+
+/**
+ * @return whether entry's stored bytes still match its checksum.
+ * */
+static bool Save_Verify(const MazeSaveEntry_t *entry) {
+  SaveStream_t stream = {.ofs = entry->data_ofs, .left = entry->data_len};
+  u8 byte;
+  for (u32 i = 0; i < entry->data_len; ++i) {
+    if (!Save_Stream_Get(&stream, &byte))
+      return false;
+  }
+  return Save_Stream_Checksum(&stream)==entry->checksum;
+}
+
+/**
+ * @brief Load the maze in slot into maze, which must already be that size.
+ * MSF_PACKED fills in the walls and grid straight from SRAM, with no
+ * generator run at all, once the stored bytes check out; MSF_SEED
+ * regenerates it.
+ * @return false on a size mismatch, bad slot or checksum mismatch, none of
+ * which touch maze.
+ * */
+bool Maze_Save_Load(int slot, Maze_t *maze) {
+  MazeSaveEntry_t entry;
+  if (!maze || !Maze_Save_Get_Entry(slot, &entry))
+    return false;
+  if (entry.width!=maze->width || entry.height!=maze->height)
+    return false;
+  switch (entry.format) {
+  case MSF_SEED:
+    return Maze_Generate_Seeded(entry.gen_id, maze, entry.seed);
+  case MSF_PACKED: {
+    MazeWalls_t *walls = &maze->walls;
+    SaveStream_t stream = {.ofs = entry.data_ofs, .left = entry.data_len};
+    u32 cell = 0;
+    u8 byte = 0;
+    if (entry.data_len!=Packed_Size(entry.width, entry.height) || !Save_Verify(&entry))
+      return false;
+    // Both planes are one allocation (see Maze_Walls_Init); raise every wall
+    for (int i = 0; i < 2*walls->row_words*walls->height; ++i)
+      walls->right[i] = 0xFFFFFFFFU;
+    for (int y = 0; y < maze->height; ++y) {
+      for (int x = 0; x < maze->width; ++x) {
+        if (!(cell&3) && !Save_Stream_Get(&stream, &byte))
+          return false;
+        u8 bits = byte>>((cell&3)<<1);
+        if (!(bits&1))
+          Maze_Walls_Carve(walls, x, y, RIGHT);
+        if (!(bits&2))
+          Maze_Walls_Carve(walls, x, y, DOWN);
+        ++cell;
+      }
+    }
+    Maze_Walls_To_Grid(walls, maze->grid);
+    maze->seed = entry.seed;
+    maze->gen_id = entry.gen_id;
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Slide the data after the gap bytes at ofs down over them, then point
+ * the index at where it moved to. Entries are kept in data order, so that's
+ * every one from first on.
+ * @return false if SRAM failed, leaving the RAM index as it was.
+ * */
+static bool Save_Compact(int first, u32 ofs, u32 gap) {
+  u8 buf[SAVE_CHUNK];
+  u32 src = ofs + gap, dst = ofs;
+  while (src < header.data_end) {
+    u32 len = header.data_end - src;
+    if (len > SAVE_CHUNK)
+      len = SAVE_CHUNK;
+    if (!SRAM_Read(buf, len, src) || !SRAM_Write(buf, len, dst))
+      return false;
+    src += len;
+    dst += len;
+  }
+  for (int i = first; i < header.entry_ct; ++i)
+    entries[i].data_ofs -= gap;
+  header.data_end -= gap;
+  if (Save_Write_Index())
+    return true;
+  for (int i = first; i < header.entry_ct; ++i)
+    entries[i].data_ofs += gap;
+  header.data_end += gap;
+  return false;
+}
+
+/**
+ * @brief Remove slot from the index, then slide later entries' data down over
+ * the freed bytes so the data area stays contiguous. The removal is written
+ * before any data moves, so the index in SRAM never points at bytes that have
+ * been moved out from under it. If compacting fails, the freed bytes stay a
+ * gap, and entries it had already partly moved fail their checksum on load.
+ * @return false if the index couldn't be rewritten, leaving slot in place.
+ * */
+bool Maze_Save_Delete(int slot) {
+  if (!ready || slot < 0 || slot >= header.entry_ct)
+    return false;
+  const MazeSaveEntry_t GONE = entries[slot];
+  for (int i = slot+1; i < header.entry_ct; ++i)
+    entries[i-1] = entries[i];
+  --header.entry_ct;
+  if (!Save_Write_Index()) {
+    for (int i = header.entry_ct; i > slot; --i)
+      entries[i] = entries[i-1];
+    entries[slot] = GONE;
+    ++header.entry_ct;
+    return false;
+  }
+  if (GONE.data_len)
+    Save_Compact(slot, GONE.data_ofs, GONE.data_len);
+  return true;
+}
@@ -0,0 +1,76 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "maze_walls.h"
+#include <stdlib.h>
+
+/**
+ * @brief Allocate both bitplanes for a grid_width x grid_height maze with
+ * every wall up.
+ * @return false if allocation fails; walls is left zeroed in that case.
+ * */
+bool Maze_Walls_Init(MazeWalls_t *walls, int grid_width, int grid_height) {
+  if (!walls || grid_width <= 0 || grid_height <= 0)
+    return false;
+  const int ROW_WORDS = (grid_width+31)>>5;
+  const size_t PLANE_WORDS = ROW_WORDS*grid_height;
+  u32 *planes = malloc(2*PLANE_WORDS*sizeof(u32));
+  *walls = (MazeWalls_t){0};
+  if (!planes)
+    return false;
+  for (size_t i = 0; i < 2*PLANE_WORDS; ++i)
+    planes[i] = 0xFFFFFFFFU;
+  walls->right = planes;
+  walls->bottom = planes + PLANE_WORDS;
+  walls->width = grid_width;
+  walls->height = grid_height;
+  walls->row_words = ROW_WORDS;
+  return true;
+}
+
+void Maze_Walls_Close(MazeWalls_t *walls) {
+  if (!walls)
+    return;
+  // Both planes share the one allocation made in Maze_Walls_Init
+  free(walls->right);
+  *walls = (MazeWalls_t){0};
+}
+
+/**
+ * @brief Pack a generated grid's right/bottom wall bits into the bitplanes,
+ * building each plane word 32 cells at a time.
+ * */
+void Maze_Walls_From_Grid(MazeWalls_t *walls, const u8 *grid) {
+  const int W = walls->width;
+  for (int y = 0; y < walls->height; ++y) {
+    u32 *right = Maze_Walls_Right_Row(walls, y),
+        *bottom = Maze_Walls_Bottom_Row(walls, y);
+    const u8 *row = grid + y*W;
+    for (int word = 0, x = 0; word < walls->row_words; ++word) {
+      // Padding past the last column stays set
+      u32 r = 0xFFFFFFFFU, b = 0xFFFFFFFFU, bit = 1;
+      for (int i = 0; i < 32 && x < W; ++i, ++x, bit <<= 1) {
+        if (!(row[x]&MF_RIGHT_WALL))
+          r ^= bit;
+        if (!(row[x]&MF_BTM_WALL))
+          b ^= bit;
+      }
+      right[word] = r;
+      bottom[word] = b;
+    }
+  }
+}
+
+/**
+ * @brief Expand the bitplanes back into a fully generated grid (all four wall
+ * bits plus MF_INITIALIZED per cell), for mazes that were loaded rather than
+ * generated.
+ * */
+void Maze_Walls_To_Grid(const MazeWalls_t *walls, u8 *grid) {
+  for (int y = 0; y < walls->height; ++y) {
+    for (int x = 0; x < walls->width; ++x) {
+      *grid++ = MF_INITIALIZED|Maze_Walls_Cell(walls, x, y);
+    }
+  }
+}
@@ -0,0 +1,39 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_def.h"
+#include "gba_types.h"
+#include "maze.h"
+#include "render_geometry.h"
+
+/**
+ * @brief Lay out a grid_width x grid_height maze, cell_px pixels a side, or
+ * fit to the screen if cell_px is 0. The only division anywhere in cell
+ * placement; the tables are built up by adding.
+ * */
+void Render_Geometry_Init(RenderGeometry_t *geo, int grid_width, int grid_height, int cell_px) {
+  if (grid_width < 1)
+    grid_width = 1;
+  if (grid_height < 1)
+    grid_height = 1;
+  if (grid_width > MAZE_DIM_MAX)
+    grid_width = MAZE_DIM_MAX;
+  if (grid_height > MAZE_DIM_MAX)
+    grid_height = MAZE_DIM_MAX;
+  geo->grid_w = grid_width;
+  geo->grid_h = grid_height;
+  geo->cell_w = cell_px ? cell_px : SCREEN_WIDTH/grid_width;
+  geo->cell_h = cell_px ? cell_px : SCREEN_HEIGHT/grid_height;
+  geo->hwall_len = geo->cell_w;
+  geo->vwall_len = geo->cell_h;
+  geo->right_ofs = geo->cell_w-1;
+  geo->btm_ofs = geo->cell_h-1;
+  geo->col_x[0] = geo->row_y[0] = geo->row_cell[0] = 0;
+  for (int x = 1; x <= grid_width; ++x)
+    geo->col_x[x] = geo->col_x[x-1] + geo->cell_w;
+  for (int y = 1; y <= grid_height; ++y) {
+    geo->row_y[y] = geo->row_y[y-1] + geo->cell_h;
+    geo->row_cell[y] = geo->row_cell[y-1] + grid_width;
+  }
+}
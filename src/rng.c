@@ -0,0 +1,29 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "rng.h"
+
+Rng_t MAZE_RNG = {0};
+
+STAT_INLN u32 splitmix32(u32 *x) {
+  u32 z = (*x += 0x9E3779B9U);
+  z = (z^(z>>16))*0x85EBCA6BU;
+  z = (z^(z>>13))*0xC2B2AE35U;
+  return z^(z>>16);
+}
+
+/**
+ * @brief Seed rng from a 32-bit seed and a stream id. The state is filled by
+ * splitmix32 from (seed, stream), so no two streams start correlated and the
+ * state is never all zero.
+ * */
+void Rng_Seed(Rng_t *rng, u32 seed, u32 stream) {
+  u32 x = seed ^ (stream*0x632BE5ABU);
+  for (int i = 0; i < 4; ++i)
+    rng->s[i] = splitmix32(&x);
+  if (!(rng->s[0]|rng->s[1]|rng->s[2]|rng->s[3]))
+    rng->s[0] = 1;
+  rng->bits = 0;
+  rng->bits_left = 0;
+}
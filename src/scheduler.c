@@ -0,0 +1,82 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_funcs.h"
+#include "gba_types.h"
+#include "cycle_timer.h"
+#include "scheduler.h"
+
+volatile u32 SCHEDULER_FRAME_CT = 0;
+
+static u32 budget = SCHEDULER_DEFAULT_BUDGET;
+static Scheduler_Frame_cb hook = NULL;
+static void *hook_userdata = NULL;
+static Scheduler_Frame_cb vblank_hook = NULL;
+static void *vblank_hook_userdata = NULL;
+
+static void Scheduler_VBlank_cb(void) {
+  ++SCHEDULER_FRAME_CT;
+}
+
+/**
+ * @brief Register the scheduler's frame counter as the VBlank IRQ callback
+ * (replacing whatever was there) and set the per-frame step budget in CPU
+ * cycles. frame_hook, if not NULL, gets called once every frame a task runs,
+ * after the task's steps for that frame.
+ * */
+void Scheduler_Init(u32 cycle_budget, Scheduler_Frame_cb frame_hook, void *userdata) {
+  budget = cycle_budget;
+  hook = frame_hook;
+  hook_userdata = userdata;
+  IRQ_Add(II_VBLANK, Scheduler_VBlank_cb, II_MAX);
+}
+
+void Scheduler_Set_Budget(u32 cycle_budget) {
+  budget = cycle_budget;
+}
+
+/**
+ * @brief Set a hook to call right after each vsync() while a task runs, i.e.
+ * at the start of VBlank, for work that has to land in VRAM between frames.
+ * NULL removes it.
+ * */
+void Scheduler_Set_VBlank_Hook(Scheduler_Frame_cb hook_cb, void *userdata) {
+  vblank_hook = hook_cb;
+  vblank_hook_userdata = userdata;
+}
+
+/**
+ * @brief Run task to completion, a budget's worth of steps per frame. At
+ * least one step runs per frame, so a step that alone blows the budget still
+ * makes progress. task->frames is set to the number of VBlanks the task spanned,
+ * task->steps to the number of steps it took and task->cycles to the CPU
+ * cycles those steps took, all updated every frame for the frame hook to
+ * read.
+ * @return TASK_DONE or TASK_FAILED, as returned by the last step.
+ * */
+TaskStatus_e Scheduler_Run(Task_t *task) {
+  TaskStatus_e status;
+  const u32 START_FRAME = SCHEDULER_FRAME_CT;
+  task->steps = task->cycles = 0;
+  for (;;) {
+    u32 cycles;
+    Cycle_Timer_Start();
+    do {
+      status = task->step(task->state);
+      ++task->steps;
+    } while (status==TASK_RUNNING && (cycles = Cycle_Timer_Read()) < budget);
+    if (status!=TASK_RUNNING)
+      cycles = Cycle_Timer_Read();
+    task->cycles += cycles;
+    task->frames = SCHEDULER_FRAME_CT - START_FRAME + 1;
+    if (hook)
+      hook(hook_userdata);
+    if (status!=TASK_RUNNING)
+      break;
+    vsync();
+    if (vblank_hook)
+      vblank_hook(vblank_hook_userdata);
+  }
+  return status;
+}
@@ -0,0 +1,155 @@
+/******************************************************************************\
+|*************************** Author: Burt O Sumner ****************************|
+|******** Copyright 2025 (C) Burt O Sumner | All Rights Reserved **************|
+\******************************************************************************/
+#include "gba_def.h"
+#include "gba_dma.h"
+#include "gba_funcs.h"
+#include "gba_mmap.h"
+#include "gba_types.h"
+#include "render_geometry.h"
+#include "sprite_overlay.h"
+
+#define DCNT_OBJ 0x1000
+#define DCNT_OBJ_1D 0x0040
+#define OBJ_ATTR0_HIDE (OBJ_MODE_HIDE<<8)
+
+// One 8x8 shape per marker, a byte per row, bit x set for pixel x
+static const u8 MARKER_ROWS[OM_MAX][8] = {
+  [OM_CURRENT] = {0x00, 0x7E, 0x42, 0x42, 0x42, 0x42, 0x7E, 0x00},
+  [OM_FRONTIER] = {0x00, 0x00, 0x00, 0x18, 0x18, 0x00, 0x00, 0x00},
+  [OM_PATH_HEAD] = {0x00, 0x18, 0x3C, 0x7E, 0x7E, 0x3C, 0x18, 0x00},
+};
+// Each marker gets its own palette bank, color at index 1
+static const u16 MARKER_COLORS[OM_MAX] = {
+  [OM_CURRENT] = 0x03FF,
+  [OM_FRONTIER] = 0x7FE0,
+  [OM_PATH_HEAD] = 0x001F,
+};
+
+static Obj_Attrs_t shadow[OVERLAY_OBJ_CT];
+// Cell and marker of each placed object, kept so the whole overlay can move
+// with the view
+static Coord_t obj_cells[OVERLAY_OBJ_CT];
+static u8 obj_markers[OVERLAY_OBJ_CT];
+// Objects [0, used_ct) have been touched since Init; the rest stay hidden
+static int used_ct = 0;
+static bool changed = false;
+static const RenderGeometry_t *geo = NULL;
+// Offset from a cell's top left to the top left of a marker centered on it
+static Coord_t mark_ofs = {0};
+// Screen's top left, in maze pixels
+static Coord_t origin = {0};
+
+/**
+ * @brief Load the marker tiles and palettes, hide every object and turn
+ * sprites on, placing markers by geometry (normally &MAZE_GEOMETRY, which
+ * must outlive the overlay). Call after Maze_Renderer_Use, which resets the
+ * display control register.
+ * */
+void Sprite_Overlay_Init(const RenderGeometry_t *geometry) {
+  Tile *tiles = TILE_MEM[4 + (OVERLAY_TILE>>9)] + (OVERLAY_TILE&511);
+  geo = geometry;
+  mark_ofs = (Coord_t){.x = (geo->cell_w>>1) - 4, .y = (geo->cell_h>>1) - 4};
+  origin = (Coord_t){.x=0, .y=0};
+  for (int m = 0; m < OM_MAX; ++m) {
+    for (int y = 0; y < 8; ++y) {
+      u32 row = 0;
+      for (int x = 0; x < 8; ++x) {
+        if (MARKER_ROWS[m][y]&(1<<x))
+          row |= 1UL<<(x<<2);
+      }
+      tiles[m][y] = row;
+    }
+    PAL_OBJ_MEM[(m<<4) + 1] = MARKER_COLORS[m];
+  }
+  oam_init(shadow, OVERLAY_OBJ_CT);
+  for (int i = 0; i < OVERLAY_OBJ_CT; ++i)
+    obj_markers[i] = OM_MAX;
+  used_ct = 0;
+  changed = false;
+  REG_DISPLAY_CNT |= DCNT_OBJ | DCNT_OBJ_1D;
+}
+
+/**
+ * @brief Hide every object and turn sprites back off.
+ * */
+void Sprite_Overlay_Close(void) {
+  Sprite_Overlay_Hide_All();
+  Sprite_Overlay_Commit();
+  REG_DISPLAY_CNT &= ~(DCNT_OBJ | DCNT_OBJ_1D);
+}
+
+/**
+ * @brief Write obj's attributes for its cell and marker, hidden if the cell
+ * is off screen (OAM coordinates wrap, so it would show up elsewhere).
+ * */
+static void Sprite_Overlay_Update(int obj) {
+  const Coord_t C = obj_cells[obj];
+  const int X = geo->col_x[C.x] + mark_ofs.x - origin.x, Y = geo->row_y[C.y] + mark_ofs.y - origin.y;
+  Obj_Attrs_t *o = shadow + obj;
+  if (X <= -8 || X >= SCREEN_WIDTH || Y <= -8 || Y >= SCREEN_HEIGHT) {
+    o->attr0.raw = OBJ_ATTR0_HIDE;
+    return;
+  }
+  // Square, 8x8, 4bpp, regular
+  o->attr0.raw = Y&0xFF;
+  o->attr1.raw = X&0x1FF;
+  o->attr2.raw = (OVERLAY_TILE + obj_markers[obj]) | (obj_markers[obj]<<12);
+}
+
+/**
+ * @brief Center object obj's marker on cell. Writes the shadow only.
+ * */
+void Sprite_Overlay_Place(int obj, OverlayMarker_e marker, Coord_t cell) {
+  if (obj < 0 || obj >= OVERLAY_OBJ_CT || (unsigned)marker >= OM_MAX || !geo)
+    return;
+  if ((unsigned)cell.x >= (unsigned)geo->grid_w || (unsigned)cell.y >= (unsigned)geo->grid_h)
+    return;
+  obj_cells[obj] = cell;
+  obj_markers[obj] = marker;
+  Sprite_Overlay_Update(obj);
+  if (obj >= used_ct)
+    used_ct = obj+1;
+  changed = true;
+}
+
+void Sprite_Overlay_Hide(int obj) {
+  if (obj < 0 || obj >= used_ct || obj_markers[obj]==OM_MAX)
+    return;
+  obj_markers[obj] = OM_MAX;
+  shadow[obj].attr0.raw = OBJ_ATTR0_HIDE;
+  changed = true;
+}
+
+/**
+ * @brief Move every placed marker to where its cell now is on screen, with
+ * the screen's top left at maze pixel view.
+ * */
+void Sprite_Overlay_Set_Origin(Coord_t view) {
+  if (view.x==origin.x && view.y==origin.y)
+    return;
+  origin = view;
+  for (int i = 0; i < used_ct; ++i) {
+    if (obj_markers[i]!=OM_MAX)
+      Sprite_Overlay_Update(i);
+  }
+  if (used_ct)
+    changed = true;
+}
+
+void Sprite_Overlay_Hide_All(void) {
+  for (int i = 0; i < used_ct; ++i)
+    Sprite_Overlay_Hide(i);
+}
+
+/**
+ * @brief Copy the shadow's touched objects into OAM, if any changed since
+ * the last commit. OAM is only safe to write in VBlank.
+ * */
+void Sprite_Overlay_Commit(void) {
+  if (!changed)
+    return;
+  DMA3_Copy32(OAM_MEM, shadow, used_ct*sizeof(Obj_Attrs_t)/4);
+  changed = false;
+}
@@ -8,14 +8,140 @@
 #include "gba_funcs.h"
 #include <ctype.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 
- 
-static int ipow(int base, u32 power) {
-  if (power&1) return base*ipow(base*base, power>>1);
-  else return power ? ipow(base*base, power>>1) : 1;
+
+#ifndef GLYPH_CACHE_SLOTS
+#define GLYPH_CACHE_SLOTS 4
+#endif
+// Background key of the transparent variant; any bg color with bit 15 set
+// draws that way
+#define GLYPH_BG_CLEAR 0x8000
+
+typedef u32 GlyphRows_t[SubPixel_Glyph_Height][SubPixel_Glyph_Width/2];
+
+/*
+ * Glyphs expanded to 16bpp for one background color, two pixels per word so
+ * a glyph row goes out as two 32-bit stores. Transparent pixels of the
+ * GLYPH_BG_CLEAR variant are 0, which no SubPixel_Pal entry but the unused
+ * first is.
+ * */
+typedef struct s_glyph_cache {
+  u16 bg;
+  // Bit per glyph already expanded
+  u32 ready[(SubPixel_Glyph_Count+31)/32];
+  GlyphRows_t glyphs[SubPixel_Glyph_Count];
+} GlyphCache_t;
+
+static GlyphCache_t *caches[GLYPH_CACHE_SLOTS];
+static int next_evict = 0, last_hit = 0;
+
+STAT_INLN u16 Glyph_Bg_Key(u16 bg_clr) {
+  return (bg_clr&0x8000) ? GLYPH_BG_CLEAR : bg_clr;
+}
+
+static void Glyph_Expand(GlyphRows_t rows, int idx, u16 bg) {
+  const u16 *data = &SubPixel_Glyph_Data[idx*SubPixel_Glyph_Height];
+  const u16 BG = (bg==GLYPH_BG_CLEAR) ? 0 : bg;
+  for (int i = 0; i < SubPixel_Glyph_Height; ++i) {
+    const SubPixel_Pair_t *pairs = (const SubPixel_Pair_t*)(data + i);
+    for (int j = 0; j < 2; ++j) {
+      u32 l = pairs[j].l ? SubPixel_Pal[pairs[j].l] : BG;
+      u32 r = pairs[j].r ? SubPixel_Pal[pairs[j].r] : BG;
+      rows[i][j] = l | (r<<16);
+    }
+  }
+}
+
+/**
+ * @return the cache for bg, taking over the least recently set up slot if no
+ * slot has it, or NULL if there's no memory for one.
+ * */
+static GlyphCache_t *Glyph_Cache_Get(u16 bg) {
+  GlyphCache_t *cache = caches[last_hit];
+  if (cache && cache->bg==bg)
+    return cache;
+  for (int i = 0; i < GLYPH_CACHE_SLOTS; ++i) {
+    if (caches[i] && caches[i]->bg==bg)
+      return caches[last_hit = i];
+  }
+  if (!caches[next_evict] && !(caches[next_evict] = malloc(sizeof(GlyphCache_t))))
+    return NULL;
+  cache = caches[last_hit = next_evict];
+  if (++next_evict==GLYPH_CACHE_SLOTS)
+    next_evict = 0;
+  cache->bg = bg;
+  memset(cache->ready, 0, sizeof(cache->ready));
+  return cache;
+}
+
+/**
+ * @brief Free every glyph cache. Text drawn afterwards sets them up again.
+ * */
+void mode3_glyph_cache_flush(void) {
+  for (int i = 0; i < GLYPH_CACHE_SLOTS; ++i) {
+    free(caches[i]);
+    caches[i] = NULL;
+  }
+  next_evict = last_hit = 0;
+}
+
+/**
+ * @brief Draw glyph idx with its top left at vbuf. Glyphs expand into the
+ * cache on first use for a given bg; with no memory for a cache, they expand
+ * onto the stack each time instead.
+ * */
+static void Glyph_Blit(u16 *vbuf, int idx, u16 bg) {
+  GlyphCache_t *cache = Glyph_Cache_Get(bg);
+  GlyphRows_t scratch;
+  u32 (*rows)[2] = scratch;
+  if (cache) {
+    if (!(cache->ready[idx>>5]&(1UL<<(idx&31)))) {
+      Glyph_Expand(cache->glyphs[idx], idx, bg);
+      cache->ready[idx>>5] |= 1UL<<(idx&31);
+    }
+    rows = cache->glyphs[idx];
+  } else {
+    Glyph_Expand(scratch, idx, bg);
+  }
+
+  if (bg!=GLYPH_BG_CLEAR) {
+    if (!((uintptr_t)vbuf&2)) {
+      for (int i = 0; i < SubPixel_Glyph_Height; ++i, vbuf += SCREEN_WIDTH) {
+        ((u32*)vbuf)[0] = rows[i][0];
+        ((u32*)vbuf)[1] = rows[i][1];
+      }
+      return;
+    }
+    for (int i = 0; i < SubPixel_Glyph_Height; ++i, vbuf += SCREEN_WIDTH) {
+      vbuf[0] = rows[i][0];
+      vbuf[1] = rows[i][0]>>16;
+      vbuf[2] = rows[i][1];
+      vbuf[3] = rows[i][1]>>16;
+    }
+    return;
+  }
+
+  // Transparent: whole words where both pixels are set, halfwords otherwise
+  for (int i = 0; i < SubPixel_Glyph_Height; ++i, vbuf += SCREEN_WIDTH) {
+    for (int j = 0; j < 2; ++j) {
+      const u32 PAIR = rows[i][j];
+      if (!PAIR)
+        continue;
+      if ((PAIR&0xFFFF) && (PAIR>>16) && !((uintptr_t)vbuf&2)) {
+        ((u32*)vbuf)[j] = PAIR;
+        continue;
+      }
+      if (PAIR&0xFFFF)
+        vbuf[j*2] = PAIR;
+      if (PAIR>>16)
+        vbuf[j*2 + 1] = PAIR>>16;
+    }
+  }
 }
 
 
@@ -23,11 +149,11 @@ static int ipow(int base, u32 power) {
  * @brief Use after encountering escape char, ASCII(27). Advance the pointer to
  * so that it's pointing to the char immediately following the esc char.
  * */
-static u16 parse_color(char **buf_ptr, bool *return_errflag) {
-  char *str = *buf_ptr;
+static u16 parse_color(const char **buf_ptr, bool *return_errflag) {
+  const char *str = *buf_ptr;
   u16 ret = 0;
   char tmp;
-  int len = 0, i = 0;
+  int len = 0;
   *return_errflag = 1;
   if (*str++ != '[')
     return 0;
@@ -43,10 +169,9 @@ static u16 parse_color(char **buf_ptr, bool *return_errflag) {
     *buf_ptr = ++str;
     return 0;  // Color won't matter anyway if EOS reached.
   }
-  for (tmp = tolower(*(str - 1 - (i = 0))); i < len;
-      tmp = tolower(*(str - 1 - ++i))) {
-    tmp = (tmp > '9' ? 10 + tmp - 'a' : tmp - '0');
-    ret += tmp*ipow(16, i);
+  for (const char *digit = str - len; digit < str; ++digit) {
+    tmp = tolower(*digit);
+    ret = (ret<<4) | (tmp > '9' ? 10 + tmp - 'a' : tmp - '0');
   }
   *buf_ptr = ++str;
   *return_errflag = 0;
@@ -54,26 +179,18 @@ static u16 parse_color(char **buf_ptr, bool *return_errflag) {
 }
 
 
-__printflike(4,5) int mode3_printf(int x, int y, u16 bg_clr, const char *restrict fmt, ...) {
+/**
+ * @brief Draw str from (x, y), wrapping at the right edge and handling the
+ * same '\n', '\t' and color escapes as mode3_printf.
+ * @return number of chars of str consumed.
+ * */
+int mode3_puts(int x, int y, u16 bg_clr, const char *str) {
   BMP_Rect_t tabrect = {
     .x=0,.y=0,.width=SubPixel_Glyph_Width*4, .height=SubPixel_Glyph_Height
   };
-  va_list args;
-  const SubPixel_Pair_t *g_row;
-  u16 *vbuf, clr_idx;
-  va_start(args, fmt);
-  int len = vsnprintf(NULL, 0, fmt, args), idx;
-  va_end(args);
-  va_start(args, fmt);
-
-  char buf[len+1];
-  va_start(args, fmt);
-  vsnprintf(buf, len+1, fmt, args);
-  if (buf[len]) buf[len] = '\0';
-  va_end(args);
-
-  char *pstr=buf, cur;
-  int x_pos=x, y_pos=y;
+  const char *pstr=str;
+  char cur;
+  int x_pos=x, y_pos=y, idx;
   bool err_flag;
 
   while ((cur=*pstr++)) {
@@ -82,7 +199,7 @@ __printflike(4,5) int mode3_printf(int x, int y, u16 bg_clr, const char *restric
         x_pos = x;
         y_pos += SubPixel_Glyph_Height;
         if ((y_pos + SubPixel_Glyph_Height) > SCREEN_HEIGHT)
-          return pstr-&buf[0] - 1;
+          return pstr - str - 1;
       } else if (cur == '\t') {
         if (!(bg_clr&0x8000)) {
           tabrect.x=x_pos;
@@ -95,7 +212,7 @@ __printflike(4,5) int mode3_printf(int x, int y, u16 bg_clr, const char *restric
       } else if (cur == '\x1b') {
         bg_clr = parse_color(&pstr, &err_flag);
         if (err_flag)
-          return pstr-&buf[0]-1;
+          return pstr - str - 1;
       }
       continue;
     }
@@ -108,60 +225,34 @@ __printflike(4,5) int mode3_printf(int x, int y, u16 bg_clr, const char *restric
     if ((x_pos + SubPixel_Glyph_Width) > SCREEN_WIDTH) {
       x_pos = x;
       y_pos += SubPixel_Glyph_Height;
-      if ((y+SubPixel_Glyph_Height) > SCREEN_HEIGHT)
-        return pstr - &(buf[0]) - 1;
-      
+      if ((y_pos + SubPixel_Glyph_Height) > SCREEN_HEIGHT)
+        return pstr - str - 1;
     }
 
-    g_row = (SubPixel_Pair_t*) (&SubPixel_Glyph_Data[idx*8]);
-    vbuf = (y_pos*SCREEN_WIDTH) + x_pos + VRAM_BUF;
-    if (bg_clr&0x8000) {
-      for (int i = 0; i < SubPixel_Glyph_Height; ++i) {
-        for (int j = 0; j < 2; ++j) {
-          if ((clr_idx=g_row[j].l)) {
-            vbuf[j*2] = SubPixel_Pal[clr_idx];
-          }
-
-          if ((clr_idx=g_row[j].r)) {
-            vbuf[j*2 + 1] = SubPixel_Pal[clr_idx];
-          }
+    Glyph_Blit((y_pos*SCREEN_WIDTH) + x_pos + VRAM_BUF, idx, Glyph_Bg_Key(bg_clr));
+    x_pos += SubPixel_Glyph_Width;
+  }
 
-        }
-        g_row += 2;
-        vbuf += SCREEN_WIDTH;
-      }
-    } else {
-
-      for (int i = 0; i < SubPixel_Glyph_Height; ++i) {
-        for (int j = 0; j < 2; ++j) {
-
-          if ((clr_idx=g_row[j].l)) {
-            vbuf[j*2] = SubPixel_Pal[clr_idx];
-          } else {
-            vbuf[j*2] = bg_clr;
-          }
- 
-          if ((clr_idx=g_row[j].r)) {
-            vbuf[j*2 + 1] = SubPixel_Pal[clr_idx];
-          } else {
-            vbuf[j*2+1] = bg_clr;
-          }
-        }
-        g_row += 2;
-        vbuf += SCREEN_WIDTH;
-      }
-    }
+  return pstr - str - 1;
+}
 
-    x_pos += SubPixel_Glyph_Width;
 
-  }
+__printflike(4,5) int mode3_printf(int x, int y, u16 bg_clr, const char *restrict fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(NULL, 0, fmt, args);
+  va_end(args);
 
-  return pstr - &buf[0] - 1;
+  char buf[len+1];
+  va_start(args, fmt);
+  vsnprintf(buf, len+1, fmt, args);
+  if (buf[len]) buf[len] = '\0';
+  va_end(args);
 
+  return mode3_puts(x, y, bg_clr, buf);
 }
 
 void mode3_putchar(int c, int x, int y, u16 bg_color) {
-  u16 *vrbuf, clr_idx;
   c -= ' ';
   if ( c < 0 || c >= SubPixel_Glyph_Count)
     return;
@@ -169,41 +260,5 @@ void mode3_putchar(int c, int x, int y, u16 bg_color) {
     return;
   if (x+4>SCREEN_WIDTH || y+8>SCREEN_HEIGHT)
     return;
-  
-  SubPixel_Pair_t *g_row = (SubPixel_Pair_t*)(&SubPixel_Glyph_Data[c*8]);
-  vrbuf = x+y*SCREEN_WIDTH+VRAM_BUF;
-  if (bg_color&0x8000) {
-    for (int i = 0; i < SubPixel_Glyph_Height; ++i) {
-      for (int j = 0; j < 2; ++j) {
-        if ((clr_idx=g_row[j].l)) {
-          vrbuf[j*2] = SubPixel_Pal[clr_idx];
-        }
-
-        if ((clr_idx=g_row[j].r)) {
-          vrbuf[j*2 + 1] = SubPixel_Pal[clr_idx];
-        }
-      }
-      vrbuf+=SCREEN_WIDTH;
-      g_row+=2;
-    }
-  
-  }
-  
-  for (int i = 0; i < SubPixel_Glyph_Height; ++i) {
-    for (int j = 0; j < 2; ++j) {
-      if ((clr_idx=g_row[j].l)) {
-        vrbuf[j*2] = SubPixel_Pal[clr_idx];
-      } else {
-        vrbuf[j*2] = bg_color;
-      }
- 
-      if ((clr_idx=g_row[j].r)) {
-        vrbuf[j*2 + 1] = SubPixel_Pal[clr_idx];
-      } else {
-        vrbuf[j*2+1] = bg_color;
-      }
-    }
-    vrbuf+=SCREEN_WIDTH;
-    g_row+=2;
-  }
+  Glyph_Blit(x+y*SCREEN_WIDTH+VRAM_BUF, c, Glyph_Bg_Key(bg_color));
 }